@@ -0,0 +1,91 @@
+/**
+ * @file bench_defect.cpp
+ * @brief Bulk angular defect kernels against the per-corner reference
+ *
+ * Usage: bench_defect [grid_size]
+ *
+ * Builds a bumpy grid_size x grid_size vertex grid (default 3163, about
+ * 10M vertices) and times compute_angular_defects() with each SIMD kernel
+ * against summing compute_vertex_angle_in_triangle() per corner.
+ */
+
+#include "mesh.h"
+#include "math_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+static Mesh* make_grid(int n) {
+    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    mesh->num_vertices = n * n;
+    mesh->num_triangles = (n - 1) * (n - 1) * 2;
+    mesh->vertices = (float*)malloc((size_t)mesh->num_vertices * 3 * sizeof(float));
+    mesh->triangles = (int*)malloc((size_t)mesh->num_triangles * 3 * sizeof(int));
+    mesh->uvs = NULL;
+
+    for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) {
+            float* p = mesh->vertices + ((size_t)y * n + x) * 3;
+            p[0] = (float)x;
+            p[1] = (float)y;
+            p[2] = 0.3f * sinf(x * 0.7f) * cosf(y * 0.4f);
+        }
+    }
+
+    int* t = mesh->triangles;
+    for (int y = 0; y < n - 1; y++) {
+        for (int x = 0; x < n - 1; x++) {
+            int v = y * n + x;
+            *t++ = v; *t++ = v + 1; *t++ = v + n;
+            *t++ = v + 1; *t++ = v + n + 1; *t++ = v + n;
+        }
+    }
+
+    return mesh;
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int n = argc > 1 ? atoi(argv[1]) : 3163;
+    Mesh* mesh = make_grid(n);
+    printf("%d vertices, %d triangles\n\n", mesh->num_vertices, mesh->num_triangles);
+
+    std::vector<float> reference(mesh->num_vertices, 2.0f * (float)M_PI);
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < mesh->num_triangles; f++) {
+        for (int k = 0; k < 3; k++) {
+            int v = mesh->triangles[f * 3 + k];
+            reference[v] -= compute_vertex_angle_in_triangle(mesh, f, v);
+        }
+    }
+    double t_reference = seconds_since(start);
+
+    printf("%-10s %10s %10s %12s\n", "kernel", "seconds", "speedup", "max |diff|");
+    printf("%-10s %10.3f %10s %12s\n", "reference", t_reference, "1.0x", "-");
+
+    const char* kernels[] = {"scalar", "sse2", "avx2"};
+    std::vector<float> defects(mesh->num_vertices);
+    for (const char* kernel : kernels) {
+        setenv("UVUNWRAP_SIMD", kernel, 1);
+        if (strcmp(angular_defect_kernel_name(), kernel) != 0) continue;
+
+        start = std::chrono::steady_clock::now();
+        compute_angular_defects(mesh, defects.data());
+        double t = seconds_since(start);
+
+        float max_diff = 0.0f;
+        for (int v = 0; v < mesh->num_vertices; v++) {
+            max_diff = fmaxf(max_diff, fabsf(defects[v] - reference[v]));
+        }
+        printf("%-10s %10.3f %9.1fx %12.2e\n", kernel, t, t_reference / t, max_diff);
+    }
+
+    free_mesh(mesh);
+    return 0;
+}
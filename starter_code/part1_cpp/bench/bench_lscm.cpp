@@ -0,0 +1,128 @@
+/**
+ * @file bench_lscm.cpp
+ * @brief LSCM solve time per solver on growing islands
+ *
+ * Usage: bench_lscm [max_vertices]
+ *
+ * Parameterizes bumpy square grids of about 10K, 100K and 1M vertices (up
+ * to max_vertices, default 1M) as one island with each LSCM solver (and
+ * each CG preconditioner, from a cold projection start) and reports
+ * assembly time, solve time, CG iterations and the largest UV difference
+ * from the Cholesky result. ldlt_again repeats the Cholesky solve with the
+ * symbolic analysis cached in an LSCMContext, and ldlt_mixed factorizes in
+ * float and refines in double (the 1M grid is over LSCM_MIXED_MAX_VERTICES,
+ * so its ldlt_mixed row is a plain Cholesky solve). SparseLU is skipped on the
+ * 1M grid unless max_vertices is given explicitly.
+ */
+
+#include "mesh.h"
+#include "lscm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+static Mesh* make_grid(int n) {
+    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    mesh->num_vertices = n * n;
+    mesh->num_triangles = (n - 1) * (n - 1) * 2;
+    mesh->vertices = (float*)malloc((size_t)mesh->num_vertices * 3 * sizeof(float));
+    mesh->triangles = (int*)malloc((size_t)mesh->num_triangles * 3 * sizeof(int));
+    mesh->uvs = NULL;
+
+    for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) {
+            float* p = mesh->vertices + ((size_t)y * n + x) * 3;
+            p[0] = (float)x;
+            p[1] = (float)y;
+            p[2] = 0.3f * sinf(x * 0.7f) * cosf(y * 0.4f);
+        }
+    }
+
+    int* t = mesh->triangles;
+    for (int y = 0; y < n - 1; y++) {
+        for (int x = 0; x < n - 1; x++) {
+            int v = y * n + x;
+            *t++ = v; *t++ = v + 1; *t++ = v + n;
+            *t++ = v + 1; *t++ = v + n + 1; *t++ = v + n;
+        }
+    }
+
+    return mesh;
+}
+
+int main(int argc, char** argv) {
+    int max_vertices = argc > 1 ? atoi(argv[1]) : 1000000;
+    int lu_limit = argc > 1 ? max_vertices : 200000;
+    const int sizes[] = {100, 317, 1000};
+
+    struct {
+        int solver;
+        int preconditioner;
+        int cached;
+        const char* name;
+    } solvers[] = {
+        {LSCM_SOLVER_LDLT, 0, 0, "ldlt"},
+        {LSCM_SOLVER_LDLT, 0, 1, "ldlt_again"},
+        {LSCM_SOLVER_LDLT_MIXED, 0, 0, "ldlt_mixed"},
+        {LSCM_SOLVER_SPARSE_LU, 0, 0, "sparse_lu"},
+        {LSCM_SOLVER_CG, LSCM_PRECOND_JACOBI, 0, "cg_jacobi"},
+        {LSCM_SOLVER_CG, LSCM_PRECOND_INCOMPLETE_CHOLESKY, 0, "cg_ichol"},
+        {LSCM_SOLVER_MULTIGRID, 0, 0, "multigrid"},
+    };
+
+    printf("%-10s %-10s %10s %10s %12s %8s %12s\n",
+           "vertices", "solver", "assemble", "solve", "nonzeros", "iters", "max |diff|");
+
+    for (int n : sizes) {
+        if (n * n > max_vertices) break;
+        Mesh* mesh = make_grid(n);
+        std::vector<int> faces(mesh->num_triangles);
+        for (int f = 0; f < mesh->num_triangles; f++) faces[f] = f;
+
+        float* reference = NULL;
+        for (const auto& s : solvers) {
+            if (s.solver == LSCM_SOLVER_SPARSE_LU && n * n > lu_limit) {
+                printf("%-10d %-10s %10s\n", mesh->num_vertices, s.name, "skipped");
+                continue;
+            }
+
+            LSCMOptions options;
+            lscm_default_options(&options);
+            options.solver = s.solver;
+            options.preconditioner = s.preconditioner;
+            options.verbose = 0;
+            if (s.cached) {
+                // Untimed first solve fills the context
+                options.context = lscm_context_create(1);
+                free(lscm_parameterize_ex(mesh, faces.data(), mesh->num_triangles, &options, NULL));
+            }
+            LSCMStats stats;
+            float* uvs = lscm_parameterize_ex(mesh, faces.data(), mesh->num_triangles,
+                                              &options, &stats);
+            lscm_context_free(options.context);
+            if (!uvs) {
+                printf("%-10d %-10s %10s\n", mesh->num_vertices, s.name, "failed");
+                continue;
+            }
+
+            float max_diff = 0.0f;
+            if (reference) {
+                for (int i = 0; i < mesh->num_vertices * 2; i++) {
+                    max_diff = fmaxf(max_diff, fabsf(uvs[i] - reference[i]));
+                }
+                free(uvs);
+            } else {
+                reference = uvs;
+            }
+            printf("%-10d %-10s %10.3f %10.3f %12lld %8d %12.2e\n", mesh->num_vertices, s.name,
+                   stats.assembly_seconds, stats.solve_seconds, stats.matrix_nonzeros,
+                   stats.iterations, max_diff);
+        }
+
+        free(reference);
+        free_mesh(mesh);
+    }
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file bench_topology.cpp
+ * @brief build_topology() against the std::map reference builder
+ *
+ * Usage: bench_topology [max_triangles] [max_threads]
+ *
+ * Builds topology for synthetic grids of about 10K, 1M and 10M triangles
+ * (capped at max_triangles) with the map reference and with
+ * build_topology_ex() on 1 and max_threads threads, checks that all agree,
+ * and prints their timings.
+ */
+
+#include "mesh.h"
+#include "topology.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <map>
+#include <thread>
+#include <utility>
+
+/**
+ * @brief Grid of n x n vertices, two triangles per cell
+ */
+static Mesh* make_grid(int n) {
+    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    mesh->num_vertices = n * n;
+    mesh->num_triangles = (n - 1) * (n - 1) * 2;
+    mesh->vertices = (float*)malloc((size_t)mesh->num_vertices * 3 * sizeof(float));
+    mesh->triangles = (int*)malloc((size_t)mesh->num_triangles * 3 * sizeof(int));
+    mesh->uvs = NULL;
+
+    for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) {
+            float* p = mesh->vertices + ((size_t)y * n + x) * 3;
+            p[0] = (float)x;
+            p[1] = (float)y;
+            p[2] = 0.0f;
+        }
+    }
+
+    int* t = mesh->triangles;
+    for (int y = 0; y < n - 1; y++) {
+        for (int x = 0; x < n - 1; x++) {
+            int v = y * n + x;
+            *t++ = v; *t++ = v + 1; *t++ = v + n;
+            *t++ = v + 1; *t++ = v + n + 1; *t++ = v + n;
+        }
+    }
+
+    return mesh;
+}
+
+/**
+ * @brief The original design: one std::map node per edge
+ */
+static TopologyInfo* build_topology_map(const Mesh* mesh) {
+    std::map<std::pair<int, int>, std::pair<int, int> > edge_map;
+
+    for (int f = 0; f < mesh->num_triangles; f++) {
+        for (int k = 0; k < 3; k++) {
+            int a = mesh->triangles[f * 3 + k];
+            int b = mesh->triangles[f * 3 + (k + 1) % 3];
+            std::pair<int, int> key(a < b ? a : b, a < b ? b : a);
+
+            auto it = edge_map.find(key);
+            if (it == edge_map.end()) {
+                edge_map[key] = std::make_pair(f, -1);
+            } else if (it->second.second < 0) {
+                it->second.second = f;
+            }
+        }
+    }
+
+    TopologyInfo* topo = (TopologyInfo*)calloc(1, sizeof(TopologyInfo));
+    topo->num_edges = (int)edge_map.size();
+    topo->edges = (int*)malloc(edge_map.size() * 2 * sizeof(int));
+    topo->edge_faces = (int*)malloc(edge_map.size() * 2 * sizeof(int));
+
+    int e = 0;
+    for (const auto& entry : edge_map) {
+        topo->edges[e * 2] = entry.first.first;
+        topo->edges[e * 2 + 1] = entry.first.second;
+        topo->edge_faces[e * 2] = entry.second.first;
+        topo->edge_faces[e * 2 + 1] = entry.second.second;
+        e++;
+    }
+
+    return topo;
+}
+
+static int topologies_equal(const TopologyInfo* a, const TopologyInfo* b) {
+    if (a->num_edges != b->num_edges) return 0;
+    size_t bytes = (size_t)a->num_edges * 2 * sizeof(int);
+    return memcmp(a->edges, b->edges, bytes) == 0 &&
+           memcmp(a->edge_faces, b->edge_faces, bytes) == 0;
+}
+
+template <typename Builder>
+static double time_build(const Mesh* mesh, Builder build, TopologyInfo** topo_out) {
+    auto start = std::chrono::steady_clock::now();
+    *topo_out = build(mesh);
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+int main(int argc, char** argv) {
+    long max_triangles = argc > 1 ? atol(argv[1]) : 10000000L;
+    int max_threads = argc > 2 ? atoi(argv[2]) : (int)std::thread::hardware_concurrency();
+    if (max_threads < 1) max_threads = 1;
+    const long sizes[] = {10000L, 1000000L, 10000000L};
+
+    printf("%12s %12s %10s %10s %10s %8s %8s\n", "triangles", "edges", "map (s)",
+           "sort (s)", "par (s)", "vs map", "vs sort");
+
+    for (long target : sizes) {
+        if (target > max_triangles) break;
+
+        int n = (int)ceil(sqrt(target / 2.0)) + 1;
+        Mesh* mesh = make_grid(n);
+
+        TopologyInfo* reference = NULL;
+        TopologyInfo* serial = NULL;
+        TopologyInfo* parallel = NULL;
+        double t_map = time_build(mesh, build_topology_map, &reference);
+        double t_serial = time_build(mesh, [](const Mesh* m) { return build_topology_ex(m, 1); }, &serial);
+        double t_parallel = time_build(mesh, [max_threads](const Mesh* m) {
+            return build_topology_ex(m, max_threads);
+        }, &parallel);
+
+        if (!serial || !parallel || !topologies_equal(reference, serial) ||
+            !topologies_equal(reference, parallel)) {
+            fprintf(stderr, "Mismatch against reference at %d triangles\n", mesh->num_triangles);
+            return 1;
+        }
+
+        printf("%12d %12d %10.3f %10.3f %10.3f %7.1fx %7.1fx\n",
+               mesh->num_triangles, serial->num_edges, t_map, t_serial, t_parallel,
+               t_map / t_parallel, t_serial / t_parallel);
+
+        free_topology(reference);
+        free_topology(serial);
+        free_topology(parallel);
+        free_mesh(mesh);
+    }
+
+    printf("(par = %d threads)\n", max_threads);
+    return 0;
+}
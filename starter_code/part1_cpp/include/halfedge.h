@@ -0,0 +1,67 @@
+/**
+ * @file halfedge.h
+ * @brief Compact half-edge mesh for fast local traversal
+ *
+ * Twin and next links over a triangle array, built without TopologyInfo.
+ *
+ * Half-edge h = 3 * f + k runs from triangles[h] to the next corner of
+ * face f, so face and origin need no storage: face = h / 3 and
+ * origin = mesh->triangles[h]. Only twin and next are stored, as flat
+ * int arrays.
+ *
+ * find_boundary_vertices() uses it on island-local triangles, where a
+ * half-edge left without a twin lies on the island boundary.
+ */
+
+#ifndef HALFEDGE_H
+#define HALFEDGE_H
+
+#include "mesh.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Half-edge connectivity of a triangle mesh
+ */
+typedef struct {
+    int num_vertices;       /**< Vertex count of the source mesh */
+    int num_halfedges;      /**< 3 * number of triangles */
+
+    const int* origin;      /**< Origin vertex per half-edge (the mesh's triangles array) */
+    int* twin;              /**< Opposite half-edge, or -1 on a boundary (num_halfedges) */
+    int* next;              /**< Next half-edge in the same face (num_halfedges) */
+} HalfEdgeMesh;
+
+/**
+ * @brief Build half-edge connectivity in O(F)
+ *
+ * Twins are matched through a per-vertex list of outgoing half-edges.
+ * On non-manifold or inconsistently oriented edges, half-edges that find
+ * no unmatched opposite partner are left as boundaries.
+ *
+ * @param mesh Input mesh; must outlive the result (origin points into it)
+ * @return Newly allocated half-edge mesh, or NULL on error
+ * @note Caller must free with free_halfedge_mesh()
+ */
+HalfEdgeMesh* build_halfedge_mesh(const Mesh* mesh);
+
+/**
+ * @brief Free half-edge mesh memory
+ * @param hm Half-edge mesh to free
+ */
+void free_halfedge_mesh(HalfEdgeMesh* hm);
+
+/**
+ * @brief Destination vertex of a half-edge
+ */
+static inline int halfedge_target(const HalfEdgeMesh* hm, int h) {
+    return hm->origin[hm->next[h]];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HALFEDGE_H */
@@ -2,7 +2,7 @@
  * @file lscm.h
  * @brief LSCM (Least Squares Conformal Maps) parameterization
  *
- * API SKELETON - YOU IMPLEMENT IN lscm.cpp
+ * Implemented in lscm.cpp and multigrid.cpp
  */
 
 #ifndef LSCM_H
@@ -14,6 +14,135 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Linear solver for the LSCM system
+ */
+typedef enum {
+    LSCM_SOLVER_SPARSE_LU = 0,  /**< General sparse LU (Eigen::SparseLU, COLAMD ordering) */
+    LSCM_SOLVER_LDLT = 1,       /**< Sparse Cholesky (Eigen::SimplicialLDLT, AMD ordering) */
+    LSCM_SOLVER_CG = 2,         /**< Preconditioned conjugate gradient */
+    LSCM_SOLVER_MULTIGRID = 3,  /**< Conjugate gradient with an aggregation multigrid
+                                     cycle; less memory than LDLT */
+    LSCM_SOLVER_LDLT_MIXED = 4  /**< Sparse Cholesky factorized in float, refined
+                                     in double; islands over LSCM_MIXED_MAX_VERTICES
+                                     use LDLT */
+} LSCMSolver;
+
+/**
+ * @brief Preconditioner for LSCM_SOLVER_CG
+ */
+typedef enum {
+    LSCM_PRECOND_JACOBI = 0,                /**< Diagonal scaling */
+    LSCM_PRECOND_INCOMPLETE_CHOLESKY = 1    /**< Incomplete Cholesky, in island vertex order */
+} LSCMPreconditioner;
+
+/**
+ * @brief Cache of symbolic factorizations shared across LSCM calls
+ *
+ * Opaque; see lscm_context_create(). Safe to share between threads.
+ */
+typedef struct LSCMContext LSCMContext;
+
+/**
+ * @brief Islands with fewer triangles are set up on the calling thread
+ *
+ * Below this size, spreading one island's mapping and assembly over
+ * workers costs more than it saves.
+ */
+#define LSCM_PARALLEL_MIN_TRIANGLES 65536
+
+/**
+ * @brief Largest island LSCM_SOLVER_LDLT_MIXED factorizes in float
+ *
+ * Refinement with the float factor was measured to converge up to this
+ * size. Beyond it the factor is too inaccurate, so larger islands go
+ * straight to the double factorization of LSCM_SOLVER_LDLT.
+ */
+#define LSCM_MIXED_MAX_VERTICES 131072
+
+/**
+ * @brief LSCM options
+ */
+typedef struct {
+    int solver;                 /**< LSCMSolver */
+    int num_threads;            /**< Workers for mapping and matrix assembly
+                                     (0 = automatic; islands under
+                                     LSCM_PARALLEL_MIN_TRIANGLES faces always
+                                     use one) */
+    int verbose;                /**< Print progress to stdout (default 1); errors
+                                     go to stderr either way */
+
+    /* LSCM_SOLVER_CG only */
+    int preconditioner;         /**< LSCMPreconditioner */
+
+    /* LSCM_SOLVER_CG and LSCM_SOLVER_MULTIGRID */
+    double tolerance;           /**< Relative residual |b - Ax| / |b| to stop at
+                                     (default 1e-10). This bounds the residual,
+                                     not the UV error, which is larger by up to
+                                     the condition number and so grows with
+                                     the island */
+    int max_iterations;         /**< Iteration cap (0 = twice the unknowns); for
+                                     LSCM_SOLVER_LDLT_MIXED, refinement steps (0 = 100) */
+    const float* initial_uvs;   /**< Warm start, [u,v, ...] in island vertex order
+                                     (e.g. a previous result), or NULL to start
+                                     from a planar projection */
+
+    /* LSCM_SOLVER_LDLT only */
+    LSCMContext* context;       /**< Reuse symbolic analyses cached here (NULL = none) */
+} LSCMOptions;
+
+/**
+ * @brief What one LSCM solve did
+ */
+typedef struct {
+    int num_vertices;           /**< Island vertices */
+    int num_unknowns;           /**< Free variables after pin elimination (2n - 4) */
+    long long matrix_nonzeros;  /**< Non-zeros of the reduced system matrix */
+    double assembly_seconds;    /**< Mapping, assembly and pin elimination */
+    double solve_seconds;       /**< Factorization and solve */
+    int iterations;             /**< CG iterations or refinement steps (0 for direct solvers) */
+    double residual;            /**< Final relative residual (0 for direct solvers) */
+    int analysis_reused;        /**< 1 if the symbolic analysis came from options->context */
+} LSCMStats;
+
+/**
+ * @brief Fill options with the defaults used by lscm_parameterize()
+ * @param options Options to initialize
+ */
+void lscm_default_options(LSCMOptions* options);
+
+/**
+ * @brief Create a cache of LSCM symbolic factorizations
+ *
+ * Factorizing the LSCM system starts with a symbolic analysis - the
+ * fill-reducing ordering and the elimination tree - that depends only on
+ * the island's connectivity and pins. Passed in LSCMOptions::context, the
+ * context keeps that analysis for every island it sees, keyed by a hash of
+ * the system's sparsity pattern, and later solves of an identical island
+ * (another run of a parameter search, an interactive re-unwrap) only redo
+ * the numeric factorization.
+ *
+ * An entry keeps only that analysis and the pattern it belongs to, about
+ * 4 bytes per system non-zero plus 16 per unknown (about 150 MB for a
+ * 1M-vertex island); numeric factors are never cached. The least recently
+ * used entry is dropped beyond max_entries.
+ *
+ * Reuse depends on Eigen 3.4's SimplicialLDLT internals. Built against
+ * another Eigen version, the context is accepted but ignored, and every
+ * solve runs its own analysis.
+ *
+ * @param max_entries Islands to remember (0 = 64)
+ * @return New context, or NULL on allocation failure
+ * @note Free with lscm_context_free()
+ */
+LSCMContext* lscm_context_create(int max_entries);
+
+/**
+ * @brief Free a context from lscm_context_create() (NULL is ignored)
+ * @param context Context to free; no solve may still be using it
+ */
+void lscm_context_free(LSCMContext* context);
+
 /**
  * @brief Parameterize a UV island using LSCM
  *
@@ -23,7 +152,7 @@ extern "C" {
  *    - For each triangle, add energy contribution
  *    - Energy: ||∇u - R_90°(∇v)||²
  * 3. Set boundary conditions (pin 2 vertices to prevent degeneracy)
- * 4. Solve sparse linear system
+ * 4. Solve sparse linear system (see lscm_parameterize_ex())
  * 5. Normalize UVs to [0,1]²
  *
  * @param mesh Input mesh
@@ -32,20 +161,87 @@ extern "C" {
  * @return Array of UVs [u,v, u,v, ...] for vertices in island
  * @note Caller must free returned array
  *
- * IMPLEMENTATION REQUIRED
- *
- * IMPORTANT: See reference/lscm_matrix_example.cpp for matrix assembly example
- *
- * Dependencies:
- * - Eigen library for sparse matrices (included in third_party/)
- * - Use Eigen::SparseLU or Eigen::ConjugateGradient
+ * Solves with lscm_default_options() (LSCM_SOLVER_LDLT, sparse Cholesky
+ * via Eigen::SimplicialLDLT). To pick another LSCMSolver, warm-start,
+ * reuse a context or get solver statistics, call lscm_parameterize_ex().
  */
 float* lscm_parameterize(const Mesh* mesh,
                          const int* face_indices,
                          int num_faces);
 
+/**
+ * @brief Parameterize a UV island using LSCM, with explicit options
+ *
+ * The conformal energy is a symmetric positive semi-definite quadratic
+ * form in the 2n unknowns. The two pinned vertices are eliminated from it
+ * (their columns move to the right-hand side), which leaves a symmetric
+ * positive definite (2n - 4) x (2n - 4) system for any connected island.
+ * LSCM_SOLVER_LDLT factorizes it with sparse Cholesky under an AMD
+ * fill-reducing ordering, reusing the ordering and elimination tree from
+ * options->context when it has seen the same island before;
+ * LSCM_SOLVER_SPARSE_LU ignores the symmetry and is kept for comparison.
+ *
+ * LSCM_SOLVER_LDLT_MIXED computes the same factorization in single
+ * precision, then recovers the double-precision answer by iterative
+ * refinement: residuals are formed in double and each correction is solved
+ * with the float factor, until the corrections fall below float resolution
+ * of the UVs. LSCM systems are too ill-conditioned for plain refinement to
+ * converge, so the corrections drive conjugate gradient. Only the factor
+ * values shrink; its index arrays and the double system do not, and the
+ * refinement steps usually cost more time than the double factorization
+ * saves, so this mode trades time for a smaller peak. The step count grows
+ * with the island, and islands over LSCM_MIXED_MAX_VERTICES vertices are
+ * solved as with LSCM_SOLVER_LDLT without trying. An island that does not
+ * converge within options->max_iterations steps, or whose residual stops
+ * falling for 16 steps, is refactorized in double as well.
+ *
+ * LSCM_SOLVER_CG iterates on the same system with a Jacobi or incomplete
+ * Cholesky preconditioner until options->tolerance or
+ * options->max_iterations is reached. It starts from options->initial_uvs
+ * or, without one, from the island projected onto its average plane; either
+ * guess is first moved by a similarity so the pins land where the solution
+ * puts them, so any earlier result (normalized or not) is a valid warm
+ * start. Running out of iterations is reported but still returns the
+ * current iterate.
+ *
+ * LSCM_SOLVER_MULTIGRID is for islands too large to factorize. It builds a
+ * hierarchy by clustering each vertex with its neighbours into one coarse
+ * node that carries the translations and similarities of its cluster,
+ * factorizes only the coarsest level (coarsening stops once a level has
+ * about a thousand unknowns) and uses one W-cycle - Gauss-Seidel smoothing
+ * on the way down and up, coarse-grid corrections in between - to
+ * precondition CG. Coarse levels are smaller but denser than the system
+ * itself, so the peak stays below LSCM_SOLVER_LDLT's but not far below
+ * it. The iteration count grows with the island size, more slowly than
+ * with the single-level preconditioners: the free boundary leaves every
+ * conformal map nearly free of energy, and no fixed coarse space captures
+ * them all.
+ * It takes the same tolerance, iteration cap and warm start as
+ * LSCM_SOLVER_CG.
+ *
+ * @param mesh Input mesh
+ * @param face_indices Indices of faces in this island
+ * @param num_faces Number of faces in island
+ * @param options Solver options (NULL for defaults)
+ * @param stats_out Output: solve statistics (may be NULL)
+ * @return Array of UVs [u,v, u,v, ...] for vertices in island, in order of
+ *         first appearance in the face list, or NULL on error
+ * @note Caller must free returned array
+ */
+float* lscm_parameterize_ex(const Mesh* mesh,
+                            const int* face_indices,
+                            int num_faces,
+                            const LSCMOptions* options,
+                            LSCMStats* stats_out);
+
 /**
  * @brief Helper: Find boundary vertices in an island
+ *
+ * Builds a half-edge mesh over the island (O(F)) and returns the ends of
+ * every half-edge without a twin, in increasing order. Edges used by more
+ * than two faces, or by two faces of opposite orientation, count as
+ * boundary.
+ *
  * @param mesh Input mesh
  * @param face_indices Faces in island
  * @param num_faces Number of faces
@@ -63,6 +63,27 @@ float compute_vertex_angle_in_triangle(const Mesh* mesh,
                                        int tri_idx,
                                        int vert_idx);
 
+/**
+ * @brief Angular defect (2π - sum of incident corner angles) of every vertex
+ *
+ * One streaming pass over the triangles: blocks of triangles are gathered
+ * into SIMD lanes (AVX2 or SSE2, picked at run time, with a scalar
+ * fallback; $UVUNWRAP_SIMD=scalar|sse2 forces a narrower one), all three
+ * corner angles are computed at once with a polynomial acos
+ * (|error| < 1e-6 rad), and the angles are scatter-added per vertex.
+ * Degenerate corners count as π/2, like compute_vertex_angle_in_triangle().
+ * Vertices without faces get 2π.
+ *
+ * @param mesh Input mesh
+ * @param defects_out Output: defect per vertex (num_vertices)
+ */
+void compute_angular_defects(const Mesh* mesh, float* defects_out);
+
+/**
+ * @brief Name of the kernel compute_angular_defects() uses ("avx2", "sse2" or "scalar")
+ */
+const char* angular_defect_kernel_name(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,203 @@
+/**
+ * @file mesh_io.h
+ * @brief Extended mesh I/O options
+ *
+ * Format-specific loaders, mesh saving and the binary mesh cache.
+ *
+ * load_obj() in mesh.h uses the defaults below; use these entry points to
+ * pick a specific loader.
+ */
+
+#ifndef MESH_IO_H
+#define MESH_IO_H
+
+#include "mesh.h"
+#include "topology.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief OBJ parser implementation
+ */
+typedef enum {
+    OBJ_LOAD_STDIO = 0,     /**< fgets/sscanf line reader (legacy) */
+    OBJ_LOAD_MMAP = 1,      /**< Memory-mapped, in-place scanner, one thread */
+    OBJ_LOAD_PARALLEL = 2   /**< Memory-mapped, chunks parsed on all cores (default) */
+} ObjLoadMode;
+
+/**
+ * @brief OBJ loading options
+ */
+typedef struct {
+    int mode;               /**< ObjLoadMode */
+    int num_threads;        /**< Workers for OBJ_LOAD_PARALLEL (0 = automatic) */
+} ObjLoadOptions;
+
+/**
+ * @brief Fill options with the defaults used by load_obj()
+ * @param options Options to initialize
+ */
+void obj_load_default_options(ObjLoadOptions* options);
+
+/**
+ * @brief Load mesh from OBJ file with explicit options
+ *
+ * OBJ_LOAD_STDIO is the original reader: triangles only, first three
+ * corners of "f a b c" / "f a/b c/d e/f" lines, no index checks.
+ *
+ * OBJ_LOAD_MMAP maps the file, counts records in a first pass to size the
+ * final Mesh arrays exactly, then parses numbers in place straight into
+ * those arrays. No intermediate buffers or copies are made.
+ *
+ * Faces may use any corner form (v, v/vt, v//vn, v/vt/vn), negative
+ * (relative) indices and any number of corners: quads are split along the
+ * shorter valid diagonal and larger polygons are ear-clipped in their own
+ * plane, all during the same load. When faces carry vt indices each vertex
+ * takes the UV of the first corner that references it. Faces with
+ * out-of-range indices are dropped with a warning.
+ *
+ * OBJ_LOAD_PARALLEL does the same on newline-aligned chunks spread over a
+ * worker pool; a prefix sum over per-chunk counts places every record at
+ * the index a serial parse would give it. Automatic thread count honours
+ * $UVUNWRAP_NUM_THREADS. Files under ~1 MiB are parsed on one thread.
+ *
+ * @param filename Path to OBJ file
+ * @param options Loader options (NULL for defaults)
+ * @return Newly allocated mesh, or NULL on error
+ * @note Caller must free with free_mesh()
+ */
+Mesh* load_obj_ex(const char* filename, const ObjLoadOptions* options);
+
+/**
+ * @brief Load mesh from binary little-endian PLY file
+ *
+ * Reads the "vertex" element's x/y/z (and u/v, s/t or texture_u/texture_v
+ * if present) and the "face" element's vertex_indices list. Other elements
+ * and properties are skipped. Vertex blocks laid out as three float32s are
+ * copied in one memcpy; polygons are triangulated like OBJ faces.
+ *
+ * @param filename Path to PLY file
+ * @return Newly allocated mesh, or NULL on error (ASCII/big-endian PLY
+ *         are reported as unsupported)
+ * @note Caller must free with free_mesh()
+ */
+Mesh* load_ply(const char* filename);
+
+/**
+ * @brief Load mesh from binary STL file
+ *
+ * STL stores three unshared corners per triangle; corners with bit-identical
+ * positions are welded through a hash table so the mesh has shared
+ * vertices (use weld tolerance tools for near-duplicates). Bytes after
+ * the last facet are ignored.
+ *
+ * @param filename Path to STL file
+ * @return Newly allocated mesh, or NULL on error (ASCII STL is reported
+ *         as unsupported)
+ * @note Caller must free with free_mesh()
+ */
+Mesh* load_stl(const char* filename);
+
+/**
+ * @brief Load a mesh, choosing the reader from the file extension
+ *
+ * .ply uses load_ply(), .stl uses load_stl(), anything else load_obj().
+ *
+ * @param filename Path to mesh file
+ * @return Newly allocated mesh, or NULL on error
+ * @note Caller must free with free_mesh()
+ */
+Mesh* load_mesh(const char* filename);
+
+/**
+ * @brief OBJ writing options
+ */
+typedef struct {
+    int dedup_uvs;          /**< If true, write each distinct UV once and index it */
+    int num_threads;        /**< Formatting threads (0 = automatic, 1 = serial) */
+} ObjSaveOptions;
+
+/**
+ * @brief Fill options with the defaults used by save_obj()
+ * @param options Options to initialize
+ */
+void obj_save_default_options(ObjSaveOptions* options);
+
+/**
+ * @brief Save mesh to OBJ file with explicit options
+ *
+ * Records are formatted into large reusable buffers with a locale-free
+ * shortest round-trip float formatter (every value reads back bit-exact)
+ * and written in big blocks. The output is split into fixed-size ranges of
+ * records; with several threads each batch of ranges is formatted in
+ * parallel into per-range buffers and written in order, so the file is
+ * byte-identical to a serial write.
+ *
+ * With dedup_uvs, repeated (u, v) pairs become a single vt record and faces
+ * are written as v/vt with the shared index.
+ *
+ * @param mesh Mesh to save
+ * @param filename Output path
+ * @param options Writer options (NULL for defaults)
+ * @return 0 on success, -1 on error
+ */
+int save_obj_ex(const Mesh* mesh, const char* filename, const ObjSaveOptions* options);
+
+/**
+ * @brief Suffix appended to a source path to name its binary cache
+ */
+#define MESH_CACHE_EXTENSION ".uvmc"
+
+/**
+ * @brief Write a mesh (and optionally its topology) to a binary cache
+ *
+ * The file holds a versioned header followed by the raw vertices,
+ * triangles, uvs, edges and edge_faces arrays. It is written under a
+ * temporary name and renamed into place.
+ *
+ * @param mesh Mesh to save
+ * @param topo Topology to store alongside (can be NULL)
+ * @param filename Output path
+ * @return 0 on success, -1 on error
+ */
+int save_mesh_cache(const Mesh* mesh, const TopologyInfo* topo, const char* filename);
+
+/**
+ * @brief Load a binary mesh cache
+ *
+ * The file is mapped copy-on-write and the returned Mesh points directly
+ * into the mapping: nothing is parsed or copied. free_mesh() releases the
+ * mapping.
+ *
+ * @param filename Cache path
+ * @param topo_out Output: stored topology, or NULL if the cache has none
+ *                 (can be NULL if not wanted)
+ * @return Mesh, or NULL if the file is missing, corrupt or from another
+ *         format version
+ * @note Caller must free with free_mesh() (and free_topology())
+ */
+Mesh* load_mesh_cache(const char* filename, TopologyInfo** topo_out);
+
+/**
+ * @brief Load a mesh file through its binary cache
+ *
+ * Uses filename + MESH_CACHE_EXTENSION when that cache is at least as new
+ * as the source. If topo_out is requested and the cache has no topology,
+ * it is built from the cached mesh and the cache is rewritten with it.
+ * Otherwise the source is read with load_mesh(), topology is built if
+ * requested, and the cache is rewritten for the next run.
+ *
+ * @param filename Path to OBJ, PLY or STL file
+ * @param topo_out Output: topology (can be NULL if not wanted)
+ * @return Mesh, or NULL on error
+ * @note Caller must free with free_mesh() (and free_topology())
+ */
+Mesh* load_mesh_auto(const char* filename, TopologyInfo** topo_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESH_IO_H */
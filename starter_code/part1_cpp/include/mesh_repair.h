@@ -0,0 +1,50 @@
+/**
+ * @file mesh_repair.h
+ * @brief Mesh clean-up passes run before topology
+ *
+ * Welds coincident vertices and drops degenerate or duplicate triangles.
+ */
+
+#ifndef MESH_REPAIR_H
+#define MESH_REPAIR_H
+
+#include "mesh.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief What weld_mesh() changed
+ */
+typedef struct {
+    int merged_vertices;         /**< Vertices folded into an earlier vertex */
+    int degenerate_triangles;    /**< Triangles dropped for repeated corners or zero area */
+    int duplicate_triangles;     /**< Triangles dropped for repeating an earlier vertex set */
+} WeldStats;
+
+/**
+ * @brief Weld coincident vertices and drop broken triangles
+ *
+ * Vertices are visited in index order; each one is merged into the first
+ * earlier kept vertex within epsilon (Euclidean), found through a spatial
+ * hash grid with epsilon-sized cells, so the pass runs in expected linear
+ * time. Kept vertices retain their order, position and UV.
+ *
+ * Triangles are then remapped, and those with repeated corners, zero area
+ * or the same three vertices as an earlier triangle (in any order or
+ * winding) are removed.
+ *
+ * @param mesh Input mesh (not modified)
+ * @param epsilon Weld distance (0 merges bit-identical positions only)
+ * @param stats_out Output: counts of what was removed (can be NULL)
+ * @return New mesh, or NULL on error
+ * @note Caller must free with free_mesh()
+ */
+Mesh* weld_mesh(const Mesh* mesh, float epsilon, WeldStats* stats_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESH_REPAIR_H */
@@ -2,7 +2,7 @@
  * @file topology.h
  * @brief Mesh topology (edges and adjacency)
  *
- * PROVIDED API - YOU IMPLEMENT IN topology.cpp
+ * Edge list plus vertex-edge, vertex-face and face-edge adjacency in CSR form.
  */
 
 #ifndef TOPOLOGY_H
@@ -20,6 +20,12 @@ extern "C" {
  * Stores:
  * - All unique edges in the mesh
  * - For each edge, the 1 or 2 adjacent faces
+ * - Compressed-sparse-row (CSR) vertex→edge and vertex→face tables, and
+ *   the edge of every triangle side, so adjacency queries cost O(degree)
+ *
+ * The edges incident to vertex v are
+ * vertex_edges[vertex_edge_offsets[v] .. vertex_edge_offsets[v + 1]),
+ * in increasing edge order; vertex_faces works the same way.
  */
 typedef struct {
     int* edges;            /**< Edge vertex pairs [v0,v1, v0,v1, ...] (2 * num_edges) */
@@ -27,6 +33,16 @@ typedef struct {
 
     int* edge_faces;       /**< Adjacent faces [f0,f1, f0,f1, ...] (2 * num_edges)
                                  f1 = -1 for boundary edges */
+
+    int num_vertices;      /**< Vertex count of the mesh this was built from */
+    int num_faces;         /**< Triangle count of the mesh this was built from */
+
+    int* vertex_edge_offsets;  /**< CSR row starts (num_vertices + 1) */
+    int* vertex_edges;         /**< Edges around each vertex (2 * num_edges) */
+    int* vertex_face_offsets;  /**< CSR row starts (num_vertices + 1) */
+    int* vertex_faces;         /**< Faces around each vertex (3 * num_faces) */
+    int* face_edges;           /**< Edge of side (tri[k], tri[k+1 mod 3]) at
+                                    [f*3 + k] (3 * num_faces) */
 } TopologyInfo;
 
 /**
@@ -41,11 +57,36 @@ typedef struct {
  * @param mesh Input mesh
  * @return Newly allocated topology info, or NULL on error
  * @note Caller must free with free_topology()
- *
- * IMPLEMENTATION REQUIRED
  */
 TopologyInfo* build_topology(const Mesh* mesh);
 
+/**
+ * @brief Build topology with an explicit worker count
+ *
+ * Edges are partitioned by ranges of their smaller vertex and each
+ * partition is resolved on its own thread; the result is identical to the
+ * single-threaded build. build_topology() uses num_threads = 0.
+ *
+ * @param mesh Input mesh
+ * @param num_threads Workers (0 = automatic, honours $UVUNWRAP_NUM_THREADS)
+ * @return Newly allocated topology info, or NULL on error
+ * @note Caller must free with free_topology()
+ */
+TopologyInfo* build_topology_ex(const Mesh* mesh, int num_threads);
+
+/**
+ * @brief Fill the adjacency tables of a topology that only has edges
+ *
+ * For topologies restored without the CSR tables (e.g. from a mesh
+ * cache): builds the vertex→edge and vertex→face tables and looks up
+ * face_edges through them. Tables that are already set are kept.
+ *
+ * @param mesh Mesh the topology was built from
+ * @param topo Topology with edges/edge_faces (modified in-place)
+ * @return 0 on success, -1 if a triangle side has no matching edge
+ */
+int build_topology_adjacency(const Mesh* mesh, TopologyInfo* topo);
+
 /**
  * @brief Free topology memory
  * @param topo Topology to free
@@ -2,7 +2,7 @@
  * @file unwrap.h
  * @brief Main UV unwrapping API
  *
- * API SKELETON - YOU IMPLEMENT IN unwrap.cpp, seam_detection.cpp, packing.cpp
+ * Seam detection, island extraction, per-island LSCM and packing entry points.
  */
 
 #ifndef UNWRAP_H
@@ -10,21 +10,51 @@
 
 #include "mesh.h"
 #include "topology.h"
+#include "lscm.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief How detect_seams_ex() chooses the cut
+ */
+typedef enum {
+    SEAM_MODE_SPANNING_TREE = 0,    /**< BFS dual tree + angular defect refinement (default) */
+    SEAM_MODE_CURVATURE_MST = 1,    /**< Curvature-weighted maximum spanning tree, pruned */
+    SEAM_MODE_SHORTEST_PATH = 2     /**< Cones joined by shortest paths over edge lengths */
+} SeamMode;
+
+/**
+ * @brief Seam detection options
+ */
+typedef struct {
+    float angle_threshold;       /**< Vertices with angular defect above this (degrees) are cones */
+    int mode;                    /**< SeamMode */
+    int num_threads;             /**< Workers for the BFS forest (0 = automatic) */
+} SeamOptions;
+
 /**
  * @brief Unwrapping parameters
  */
 typedef struct {
     float angle_threshold;       /**< Seam detection angle threshold (degrees) */
-    int min_island_faces;        /**< Minimum island size (merge smaller islands) */
+    int min_island_faces;        /**< Minimum island size; smaller islands merge into a neighbour */
     int pack_islands;            /**< If true, pack islands into [0,1]² */
     float island_margin;         /**< Spacing between islands (e.g., 0.02) */
+    float weld_epsilon;          /**< If > 0, weld vertices this close first (see weld_mesh()) */
+    int seam_mode;               /**< SeamMode used to cut the mesh */
+    int num_threads;             /**< Workers for seams and per-island LSCM (0 = automatic) */
+    LSCMContext* lscm_context;   /**< Reuse LSCM symbolic analyses across calls
+                                      (NULL = none, see lscm_context_create()) */
 } UnwrapParams;
 
+/**
+ * @brief Fill params with the default settings
+ * @param params Parameters to initialize
+ */
+void unwrap_default_params(UnwrapParams* params);
+
 /**
  * @brief Unwrapping result metadata
  */
@@ -40,10 +70,19 @@ typedef struct {
  * @brief Main unwrapping function
  *
  * Algorithm:
+ * 0. Optionally weld coincident vertices (params->weld_epsilon > 0); the
+ *    returned mesh and face_island_ids then follow the welded mesh
  * 1. Build mesh topology
- * 2. Detect seams using spanning tree + angular defect
- * 3. Extract UV islands (connected components after seam cuts)
- * 4. Parameterize each island using LSCM
+ * 2. Detect seams (params->seam_mode, see detect_seams_ex())
+ * 3. Extract UV islands (connected components after seam cuts), merging
+ *    islands under params->min_island_faces into the neighbour they share
+ *    the longest seam with
+ * 4. Parameterize each island using LSCM. Islands of at least
+ *    LSCM_PARALLEL_MIN_TRIANGLES faces run one at a time on all
+ *    params->num_threads workers; smaller ones are spread over the workers
+ *    (largest first). A vertex shared by several islands takes its UV from
+ *    the highest-numbered one. Islands already seen by
+ *    params->lscm_context skip the symbolic analysis
  * 5. Pack islands into [0,1]²
  * 6. Compute quality metrics
  *
@@ -52,8 +91,6 @@ typedef struct {
  * @param result_out Output metadata (allocated by function)
  * @return New mesh with UVs, or NULL on error
  * @note Caller must free result mesh and result_out
- *
- * IMPLEMENTATION REQUIRED
  */
 Mesh* unwrap_mesh(const Mesh* mesh,
                   const UnwrapParams* params,
@@ -74,14 +111,50 @@ Mesh* unwrap_mesh(const Mesh* mesh,
  * @param num_seams_out Output: number of seams detected
  * @return Array of seam edge indices
  * @note Caller must free returned array
- *
- * IMPLEMENTATION REQUIRED - seam_detection.cpp
  */
 int* detect_seams(const Mesh* mesh,
                   const TopologyInfo* topo,
                   float angle_threshold,
                   int* num_seams_out);
 
+/**
+ * @brief Fill options with the defaults used by detect_seams()
+ * @param options Options to initialize
+ */
+void seam_default_options(SeamOptions* options);
+
+/**
+ * @brief Detect seams with explicit options
+ *
+ * SEAM_MODE_SPANNING_TREE is the algorithm of detect_seams().
+ *
+ * SEAM_MODE_CURVATURE_MST builds a maximum spanning tree of the dual graph
+ * with Kruskal and union-find, weighting each interior edge by
+ * length * (pi - dihedral bend), so long flat edges stay joined and short
+ * sharp ones are cut first. The interior edges left out of the tree are
+ * then pruned: dangling cut edges ending at a vertex that is neither a
+ * cone nor on the boundary are removed until every remaining branch ends
+ * at one. Each closed, cone-free component keeps a single cut edge.
+ *
+ * SEAM_MODE_SHORTEST_PATH prunes the same cut back to the boundary only,
+ * keeping just the loops a non-disk surface needs, then joins every cone
+ * to the others or to that cut/boundary along shortest edge paths: a
+ * multi-source Dijkstra from all of them, followed by Mehlhorn's Steiner
+ * tree approximation. Each cone costs one path instead of a branch of the
+ * spanning tree.
+ *
+ * @param mesh Input mesh
+ * @param topo Topology information
+ * @param options Seam options (NULL for defaults)
+ * @param num_seams_out Output: number of seams detected
+ * @return Array of seam edge indices (in increasing order), or NULL on error
+ * @note Caller must free returned array
+ */
+int* detect_seams_ex(const Mesh* mesh,
+                     const TopologyInfo* topo,
+                     const SeamOptions* options,
+                     int* num_seams_out);
+
 /**
  * @brief Pack UV islands into [0,1]² texture space
  *
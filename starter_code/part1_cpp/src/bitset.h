@@ -0,0 +1,39 @@
+/**
+ * @file bitset.h
+ * @brief Flat bit array for per-edge / per-face flags
+ *
+ * INTERNAL - not installed with the public headers
+ */
+
+#ifndef BITSET_H
+#define BITSET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief Fixed-size set of bits, 64 per word
+ *
+ * Not thread-safe for writers: bits in the same 64-bit word share storage.
+ */
+struct BitSet {
+    std::vector<uint64_t> words;
+
+    BitSet() {}
+    explicit BitSet(size_t num_bits) : words((num_bits + 63) / 64, 0) {}
+
+    void resize(size_t num_bits) { words.assign((num_bits + 63) / 64, 0); }
+
+    bool test(size_t i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+    void set(size_t i) { words[i >> 6] |= (uint64_t)1 << (i & 63); }
+    void reset(size_t i) { words[i >> 6] &= ~((uint64_t)1 << (i & 63)); }
+
+    size_t count() const {
+        size_t n = 0;
+        for (uint64_t w : words) n += (size_t)__builtin_popcountll(w);
+        return n;
+    }
+};
+
+#endif /* BITSET_H */
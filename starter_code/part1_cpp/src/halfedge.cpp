@@ -0,0 +1,72 @@
+/**
+ * @file halfedge.cpp
+ * @brief Half-edge construction
+ *
+ * Builds twin and next links by matching opposite half-edges per vertex.
+ */
+
+#include "halfedge.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+HalfEdgeMesh* build_halfedge_mesh(const Mesh* mesh) {
+    if (!mesh || !mesh->triangles || mesh->num_vertices <= 0) return NULL;
+
+    int nv = mesh->num_vertices;
+    int nh = mesh->num_triangles * 3;
+    const int* origin = mesh->triangles;
+
+    for (int h = 0; h < nh; h++) {
+        if (origin[h] < 0 || origin[h] >= nv) {
+            fprintf(stderr, "build_halfedge_mesh: Face %d has invalid vertex index\n", h / 3);
+            return NULL;
+        }
+    }
+
+    HalfEdgeMesh* hm = (HalfEdgeMesh*)malloc(sizeof(HalfEdgeMesh));
+    hm->num_vertices = nv;
+    hm->num_halfedges = nh;
+    hm->origin = origin;
+    hm->twin = (int*)malloc((size_t)nh * sizeof(int));
+    hm->next = (int*)malloc((size_t)nh * sizeof(int));
+
+    for (int h = 0; h < nh; h++) {
+        hm->next[h] = (h % 3 == 2) ? h - 2 : h + 1;
+        hm->twin[h] = -1;
+    }
+
+    // Outgoing half-edges per vertex (CSR, counting fill)
+    std::vector<int> out_offsets(nv + 1, 0);
+    for (int h = 0; h < nh; h++) out_offsets[origin[h] + 1]++;
+    for (int v = 0; v < nv; v++) out_offsets[v + 1] += out_offsets[v];
+
+    std::vector<int> out_halfedges(nh);
+    std::vector<int> cursor(out_offsets.begin(), out_offsets.end() - 1);
+    for (int h = 0; h < nh; h++) out_halfedges[cursor[origin[h]]++] = h;
+
+    // Twin of a->b is an unmatched b->a among b's outgoing half-edges
+    for (int h = 0; h < nh; h++) {
+        if (hm->twin[h] >= 0) continue;
+        int a = origin[h];
+        int b = origin[hm->next[h]];
+        for (int i = out_offsets[b]; i < out_offsets[b + 1]; i++) {
+            int g = out_halfedges[i];
+            if (g != h && hm->twin[g] < 0 && origin[hm->next[g]] == a) {
+                hm->twin[h] = g;
+                hm->twin[g] = h;
+                break;
+            }
+        }
+    }
+
+    return hm;
+}
+
+void free_halfedge_mesh(HalfEdgeMesh* hm) {
+    if (!hm) return;
+
+    if (hm->twin) free(hm->twin);
+    if (hm->next) free(hm->next);
+    free(hm);
+}
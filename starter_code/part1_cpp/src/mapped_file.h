@@ -0,0 +1,137 @@
+/**
+ * @file mapped_file.h
+ * @brief Read-only file mapping helper shared by the mesh loaders
+ *
+ * INTERNAL - not installed with the public headers
+ *
+ * On POSIX systems the file is mapped with mmap(); elsewhere the whole file
+ * is read into a heap buffer so callers can treat both cases identically.
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include "mesh.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#define MAPPED_FILE_USE_MMAP 0
+#else
+#define MAPPED_FILE_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief A file mapped (or read) into memory
+ */
+struct MappedFile {
+    char* data;         /**< First byte of the file (NULL for empty files) */
+    size_t size;        /**< File size in bytes */
+    int is_mapped;      /**< 1 if data came from mmap, 0 if from malloc */
+};
+
+/**
+ * @brief Map a whole file into memory
+ *
+ * @param filename Path to file
+ * @param writable If nonzero, pages are private copy-on-write so callers may
+ *                 modify them without touching the file on disk
+ * @param mf Output mapping
+ * @return 0 on success, -1 on error
+ */
+static inline int map_file(const char* filename, int writable, MappedFile* mf) {
+    mf->data = NULL;
+    mf->size = 0;
+    mf->is_mapped = 0;
+
+#if MAPPED_FILE_USE_MMAP
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    mf->size = (size_t)st.st_size;
+    if (mf->size > 0) {
+        int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+        void* p = mmap(NULL, mf->size, prot, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+        madvise(p, mf->size, MADV_SEQUENTIAL);
+        mf->data = (char*)p;
+        mf->is_mapped = 1;
+    }
+
+    close(fd);
+    return 0;
+#else
+    (void)writable;
+    FILE* f = fopen(filename, "rb");
+    if (!f) return -1;
+
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (len < 0) {
+        fclose(f);
+        return -1;
+    }
+
+    mf->size = (size_t)len;
+    if (mf->size > 0) {
+        mf->data = (char*)malloc(mf->size);
+        if (!mf->data || fread(mf->data, 1, mf->size, f) != mf->size) {
+            free(mf->data);
+            mf->data = NULL;
+            fclose(f);
+            return -1;
+        }
+    }
+
+    fclose(f);
+    return 0;
+#endif
+}
+
+/**
+ * @brief Release a mapping created by map_file()
+ */
+static inline void unmap_file(MappedFile* mf) {
+    if (!mf->data) return;
+
+#if MAPPED_FILE_USE_MMAP
+    if (mf->is_mapped) {
+        munmap(mf->data, mf->size);
+    } else {
+        free(mf->data);
+    }
+#else
+    free(mf->data);
+#endif
+
+    mf->data = NULL;
+    mf->size = 0;
+}
+
+/**
+ * @brief Release a mesh returned by load_mesh_cache()
+ *
+ * Implemented in mesh_cache.cpp; called by free_mesh().
+ *
+ * @param mesh Mesh to release
+ * @return 1 if the mesh was backed by a cache mapping (and is now freed),
+ *         0 if it is an ordinary heap mesh
+ */
+int release_mapped_mesh(Mesh* mesh);
+
+#endif /* MAPPED_FILE_H */
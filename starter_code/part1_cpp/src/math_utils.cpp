@@ -8,6 +8,8 @@
 #include "math_utils.h"
 #include "mesh.h"
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
 /* Vector3 operations */
 Vec3 vec3_add(Vec3 a, Vec3 b) {
@@ -129,3 +131,232 @@ float compute_vertex_angle_in_triangle(const Mesh* mesh,
 
     return angle;
 }
+
+/* Bulk angular defect */
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define MATH_UTILS_X86 1
+#else
+#define MATH_UTILS_X86 0
+#endif
+
+#if MATH_UTILS_X86 && defined(__GNUC__)
+#define MATH_UTILS_HAVE_AVX2 1
+#else
+#define MATH_UTILS_HAVE_AVX2 0
+#endif
+
+#define DEFECT_BLOCK 8
+#define DEFECT_PI 3.14159265358979f
+
+/**
+ * @brief Positions of DEFECT_BLOCK triangles, one array per coordinate
+ */
+struct TriangleBlock {
+    float x[3][DEFECT_BLOCK];
+    float y[3][DEFECT_BLOCK];
+    float z[3][DEFECT_BLOCK];
+};
+
+/* Abramowitz & Stegun 4.4.46: acos(x) = sqrt(1 - x) * poly(x) on [0, 1] */
+static const float kAcos[8] = {
+    1.5707963050f, -0.2145988016f, 0.0889789874f, -0.0501743046f,
+    0.0308918810f, -0.0170881256f, 0.0066700901f, -0.0012624911f
+};
+
+static inline float acos_poly(float x) {
+    float ax = fabsf(x);
+    if (ax > 1.0f) ax = 1.0f;
+    float p = kAcos[7];
+    for (int i = 6; i >= 0; i--) p = p * ax + kAcos[i];
+    float r = sqrtf(1.0f - ax) * p;
+    return x < 0.0f ? DEFECT_PI - r : r;
+}
+
+/**
+ * @brief Angle between a and b (π/2 if either is shorter than 1e-8)
+ */
+static inline float corner_angle_scalar(float ax, float ay, float az,
+                                        float bx, float by, float bz) {
+    float la = ax * ax + ay * ay + az * az;
+    float lb = bx * bx + by * by + bz * bz;
+    float c = 0.0f;
+    if (la >= 1e-16f && lb >= 1e-16f) {
+        c = (ax * bx + ay * by + az * bz) / (sqrtf(la) * sqrtf(lb));
+    }
+    return acos_poly(c);
+}
+
+static void block_angles_scalar(const TriangleBlock* b, float angles[3][DEFECT_BLOCK]) {
+    for (int i = 0; i < DEFECT_BLOCK; i++) {
+        float e01x = b->x[1][i] - b->x[0][i], e01y = b->y[1][i] - b->y[0][i], e01z = b->z[1][i] - b->z[0][i];
+        float e02x = b->x[2][i] - b->x[0][i], e02y = b->y[2][i] - b->y[0][i], e02z = b->z[2][i] - b->z[0][i];
+        float e12x = b->x[2][i] - b->x[1][i], e12y = b->y[2][i] - b->y[1][i], e12z = b->z[2][i] - b->z[1][i];
+        angles[0][i] = corner_angle_scalar(e01x, e01y, e01z, e02x, e02y, e02z);
+        angles[1][i] = corner_angle_scalar(-e01x, -e01y, -e01z, e12x, e12y, e12z);
+        angles[2][i] = corner_angle_scalar(e02x, e02y, e02z, e12x, e12y, e12z);
+    }
+}
+
+#if MATH_UTILS_X86
+
+static inline __m128 acos_sse(__m128 x) {
+    const __m128 sign_mask = _mm_set1_ps(-0.0f);
+    __m128 ax = _mm_min_ps(_mm_andnot_ps(sign_mask, x), _mm_set1_ps(1.0f));
+    __m128 p = _mm_set1_ps(kAcos[7]);
+    for (int i = 6; i >= 0; i--) p = _mm_add_ps(_mm_mul_ps(p, ax), _mm_set1_ps(kAcos[i]));
+    __m128 r = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), ax)), p);
+    __m128 neg = _mm_cmplt_ps(x, _mm_setzero_ps());
+    __m128 flipped = _mm_sub_ps(_mm_set1_ps(DEFECT_PI), r);
+    return _mm_or_ps(_mm_and_ps(neg, flipped), _mm_andnot_ps(neg, r));
+}
+
+static inline __m128 corner_angle_sse(__m128 ax, __m128 ay, __m128 az,
+                                      __m128 bx, __m128 by, __m128 bz) {
+    __m128 la = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, ax), _mm_mul_ps(ay, ay)), _mm_mul_ps(az, az));
+    __m128 lb = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bx, bx), _mm_mul_ps(by, by)), _mm_mul_ps(bz, bz));
+    __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+    __m128 tiny = _mm_set1_ps(1e-16f);
+    __m128 valid = _mm_and_ps(_mm_cmpge_ps(la, tiny), _mm_cmpge_ps(lb, tiny));
+    __m128 c = _mm_div_ps(dot, _mm_mul_ps(_mm_sqrt_ps(la), _mm_sqrt_ps(lb)));
+    return acos_sse(_mm_and_ps(valid, c));
+}
+
+static void block_angles_sse2(const TriangleBlock* b, float angles[3][DEFECT_BLOCK]) {
+    for (int i = 0; i < DEFECT_BLOCK; i += 4) {
+        __m128 x0 = _mm_loadu_ps(&b->x[0][i]), y0 = _mm_loadu_ps(&b->y[0][i]), z0 = _mm_loadu_ps(&b->z[0][i]);
+        __m128 x1 = _mm_loadu_ps(&b->x[1][i]), y1 = _mm_loadu_ps(&b->y[1][i]), z1 = _mm_loadu_ps(&b->z[1][i]);
+        __m128 x2 = _mm_loadu_ps(&b->x[2][i]), y2 = _mm_loadu_ps(&b->y[2][i]), z2 = _mm_loadu_ps(&b->z[2][i]);
+
+        __m128 e01x = _mm_sub_ps(x1, x0), e01y = _mm_sub_ps(y1, y0), e01z = _mm_sub_ps(z1, z0);
+        __m128 e02x = _mm_sub_ps(x2, x0), e02y = _mm_sub_ps(y2, y0), e02z = _mm_sub_ps(z2, z0);
+        __m128 e12x = _mm_sub_ps(x2, x1), e12y = _mm_sub_ps(y2, y1), e12z = _mm_sub_ps(z2, z1);
+        __m128 zero = _mm_setzero_ps();
+
+        _mm_storeu_ps(&angles[0][i], corner_angle_sse(e01x, e01y, e01z, e02x, e02y, e02z));
+        _mm_storeu_ps(&angles[1][i], corner_angle_sse(_mm_sub_ps(zero, e01x), _mm_sub_ps(zero, e01y),
+                                                      _mm_sub_ps(zero, e01z), e12x, e12y, e12z));
+        _mm_storeu_ps(&angles[2][i], corner_angle_sse(e02x, e02y, e02z, e12x, e12y, e12z));
+    }
+}
+
+#endif /* MATH_UTILS_X86 */
+
+#if MATH_UTILS_HAVE_AVX2
+
+__attribute__((target("avx2")))
+static inline __m256 acos_avx2(__m256 x) {
+    const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+    __m256 ax = _mm256_min_ps(_mm256_andnot_ps(sign_mask, x), _mm256_set1_ps(1.0f));
+    __m256 p = _mm256_set1_ps(kAcos[7]);
+    for (int i = 6; i >= 0; i--) p = _mm256_add_ps(_mm256_mul_ps(p, ax), _mm256_set1_ps(kAcos[i]));
+    __m256 r = _mm256_mul_ps(_mm256_sqrt_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), ax)), p);
+    __m256 neg = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ);
+    return _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(DEFECT_PI), r), neg);
+}
+
+__attribute__((target("avx2")))
+static inline __m256 corner_angle_avx2(__m256 ax, __m256 ay, __m256 az,
+                                       __m256 bx, __m256 by, __m256 bz) {
+    __m256 la = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax, ax), _mm256_mul_ps(ay, ay)), _mm256_mul_ps(az, az));
+    __m256 lb = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(bx, bx), _mm256_mul_ps(by, by)), _mm256_mul_ps(bz, bz));
+    __m256 dot = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax, bx), _mm256_mul_ps(ay, by)), _mm256_mul_ps(az, bz));
+    __m256 tiny = _mm256_set1_ps(1e-16f);
+    __m256 valid = _mm256_and_ps(_mm256_cmp_ps(la, tiny, _CMP_GE_OQ), _mm256_cmp_ps(lb, tiny, _CMP_GE_OQ));
+    __m256 c = _mm256_div_ps(dot, _mm256_mul_ps(_mm256_sqrt_ps(la), _mm256_sqrt_ps(lb)));
+    return acos_avx2(_mm256_and_ps(valid, c));
+}
+
+__attribute__((target("avx2")))
+static void block_angles_avx2(const TriangleBlock* b, float angles[3][DEFECT_BLOCK]) {
+    __m256 x0 = _mm256_loadu_ps(b->x[0]), y0 = _mm256_loadu_ps(b->y[0]), z0 = _mm256_loadu_ps(b->z[0]);
+    __m256 x1 = _mm256_loadu_ps(b->x[1]), y1 = _mm256_loadu_ps(b->y[1]), z1 = _mm256_loadu_ps(b->z[1]);
+    __m256 x2 = _mm256_loadu_ps(b->x[2]), y2 = _mm256_loadu_ps(b->y[2]), z2 = _mm256_loadu_ps(b->z[2]);
+
+    __m256 e01x = _mm256_sub_ps(x1, x0), e01y = _mm256_sub_ps(y1, y0), e01z = _mm256_sub_ps(z1, z0);
+    __m256 e02x = _mm256_sub_ps(x2, x0), e02y = _mm256_sub_ps(y2, y0), e02z = _mm256_sub_ps(z2, z0);
+    __m256 e12x = _mm256_sub_ps(x2, x1), e12y = _mm256_sub_ps(y2, y1), e12z = _mm256_sub_ps(z2, z1);
+    __m256 zero = _mm256_setzero_ps();
+
+    _mm256_storeu_ps(angles[0], corner_angle_avx2(e01x, e01y, e01z, e02x, e02y, e02z));
+    _mm256_storeu_ps(angles[1], corner_angle_avx2(_mm256_sub_ps(zero, e01x), _mm256_sub_ps(zero, e01y),
+                                                  _mm256_sub_ps(zero, e01z), e12x, e12y, e12z));
+    _mm256_storeu_ps(angles[2], corner_angle_avx2(e02x, e02y, e02z, e12x, e12y, e12z));
+}
+
+#endif /* MATH_UTILS_HAVE_AVX2 */
+
+typedef void (*BlockAnglesFn)(const TriangleBlock*, float[3][DEFECT_BLOCK]);
+
+/**
+ * @brief Widest kernel the CPU supports, or the one $UVUNWRAP_SIMD names
+ *        ("scalar", "sse2", "avx2") if that is available
+ */
+static BlockAnglesFn select_block_angles(const char** name) {
+    const char* forced = getenv("UVUNWRAP_SIMD");
+
+    if (forced && strcmp(forced, "scalar") == 0) {
+        *name = "scalar";
+        return block_angles_scalar;
+    }
+#if MATH_UTILS_HAVE_AVX2
+    if (!(forced && strcmp(forced, "sse2") == 0) && __builtin_cpu_supports("avx2")) {
+        *name = "avx2";
+        return block_angles_avx2;
+    }
+#endif
+#if MATH_UTILS_X86
+    *name = "sse2";
+    return block_angles_sse2;
+#else
+    *name = "scalar";
+    return block_angles_scalar;
+#endif
+}
+
+const char* angular_defect_kernel_name(void) {
+    const char* name;
+    select_block_angles(&name);
+    return name;
+}
+
+void compute_angular_defects(const Mesh* mesh, float* defects_out) {
+    if (!mesh || !defects_out) return;
+
+    const char* name;
+    BlockAnglesFn block_angles = select_block_angles(&name);
+
+    const float two_pi = 2.0f * DEFECT_PI;
+    for (int v = 0; v < mesh->num_vertices; v++) defects_out[v] = two_pi;
+
+    const float* pos = mesh->vertices;
+    const int* tris = mesh->triangles;
+    TriangleBlock block;
+    float angles[3][DEFECT_BLOCK];
+
+    for (int first = 0; first < mesh->num_triangles; first += DEFECT_BLOCK) {
+        int count = mesh->num_triangles - first;
+        if (count > DEFECT_BLOCK) count = DEFECT_BLOCK;
+
+        // Gather; a short last block repeats its final triangle
+        for (int i = 0; i < DEFECT_BLOCK; i++) {
+            const int* tri = tris + (size_t)(first + (i < count ? i : count - 1)) * 3;
+            for (int k = 0; k < 3; k++) {
+                const float* p = pos + (size_t)tri[k] * 3;
+                block.x[k][i] = p[0];
+                block.y[k][i] = p[1];
+                block.z[k][i] = p[2];
+            }
+        }
+
+        block_angles(&block, angles);
+
+        for (int i = 0; i < count; i++) {
+            const int* tri = tris + (size_t)(first + i) * 3;
+            defects_out[tri[0]] -= angles[0][i];
+            defects_out[tri[1]] -= angles[1][i];
+            defects_out[tri[2]] -= angles[2][i];
+        }
+    }
+}
@@ -0,0 +1,345 @@
+/**
+ * @file mesh_cache.cpp
+ * @brief Binary mesh cache (.uvmc)
+ *
+ * Saves meshes to a memory-mappable binary file and loads them back.
+ *
+ * File layout (host byte order, every section 64-byte aligned):
+ *
+ *   MeshCacheHeader
+ *   vertices    float[3 * num_vertices]
+ *   triangles   int32[3 * num_triangles]
+ *   uvs         float[2 * num_vertices]       (MESH_CACHE_HAS_UVS)
+ *   edges       int32[2 * num_edges]          (MESH_CACHE_HAS_TOPOLOGY)
+ *   edge_faces  int32[2 * num_edges]          (MESH_CACHE_HAS_TOPOLOGY)
+ *
+ * Loading maps the file copy-on-write and points the Mesh arrays into the
+ * mapping, so a cached mesh is ready without parsing or copying. Only
+ * edges are stored; the adjacency tables are rebuilt from them on load.
+ * The mapping is remembered in a registry keyed by Mesh pointer and
+ * released by free_mesh().
+ */
+
+#include "mesh_io.h"
+#include "topology.h"
+#include "mapped_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#define MESH_CACHE_VERSION 1
+#define MESH_CACHE_ALIGN 64
+#define MESH_CACHE_ENDIAN_TAG 0x01020304u
+
+#define MESH_CACHE_HAS_UVS 0x1u
+#define MESH_CACHE_HAS_TOPOLOGY 0x2u
+
+/**
+ * @brief On-disk header, followed by the array sections
+ */
+struct MeshCacheHeader {
+    char magic[8];              /**< "UVMCACHE" */
+    uint32_t version;           /**< MESH_CACHE_VERSION */
+    uint32_t endian_tag;        /**< MESH_CACHE_ENDIAN_TAG as written by the host */
+    uint32_t flags;             /**< MESH_CACHE_HAS_* */
+    int32_t num_vertices;
+    int32_t num_triangles;
+    int32_t num_edges;
+    uint64_t vertices_offset;
+    uint64_t triangles_offset;
+    uint64_t uvs_offset;
+    uint64_t edges_offset;
+    uint64_t edge_faces_offset;
+    uint64_t file_size;
+};
+
+static const char kMeshCacheMagic[8] = {'U', 'V', 'M', 'C', 'A', 'C', 'H', 'E'};
+
+/**
+ * @brief Mappings backing meshes returned by load_mesh_cache()
+ */
+static std::mutex g_mapped_meshes_mutex;
+static std::unordered_map<Mesh*, MappedFile> g_mapped_meshes;
+
+static uint64_t align_offset(uint64_t offset) {
+    return (offset + MESH_CACHE_ALIGN - 1) & ~(uint64_t)(MESH_CACHE_ALIGN - 1);
+}
+
+/**
+ * @brief Write size bytes at offset, zero-filling any gap before it
+ */
+static int write_section(FILE* f, uint64_t* pos, uint64_t offset,
+                         const void* data, size_t size) {
+    static const char zeros[MESH_CACHE_ALIGN] = {0};
+    while (*pos < offset) {
+        size_t pad = (size_t)(offset - *pos);
+        if (pad > sizeof(zeros)) pad = sizeof(zeros);
+        if (fwrite(zeros, 1, pad, f) != pad) return -1;
+        *pos += pad;
+    }
+    if (size > 0 && fwrite(data, 1, size, f) != size) return -1;
+    *pos += size;
+    return 0;
+}
+
+int save_mesh_cache(const Mesh* mesh, const TopologyInfo* topo, const char* filename) {
+    if (!mesh || !filename) return -1;
+
+    size_t vertices_bytes = (size_t)mesh->num_vertices * 3 * sizeof(float);
+    size_t triangles_bytes = (size_t)mesh->num_triangles * 3 * sizeof(int32_t);
+    size_t uvs_bytes = mesh->uvs ? (size_t)mesh->num_vertices * 2 * sizeof(float) : 0;
+    size_t edges_bytes = topo ? (size_t)topo->num_edges * 2 * sizeof(int32_t) : 0;
+
+    MeshCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kMeshCacheMagic, sizeof(header.magic));
+    header.version = MESH_CACHE_VERSION;
+    header.endian_tag = MESH_CACHE_ENDIAN_TAG;
+    header.flags = (mesh->uvs ? MESH_CACHE_HAS_UVS : 0) | (topo ? MESH_CACHE_HAS_TOPOLOGY : 0);
+    header.num_vertices = mesh->num_vertices;
+    header.num_triangles = mesh->num_triangles;
+    header.num_edges = topo ? topo->num_edges : 0;
+
+    uint64_t offset = align_offset(sizeof(header));
+    header.vertices_offset = offset;
+    offset = align_offset(offset + vertices_bytes);
+    header.triangles_offset = offset;
+    offset = align_offset(offset + triangles_bytes);
+    header.uvs_offset = offset;
+    offset = align_offset(offset + uvs_bytes);
+    header.edges_offset = offset;
+    offset = align_offset(offset + edges_bytes);
+    header.edge_faces_offset = offset;
+    header.file_size = offset + edges_bytes;
+
+    // Write to a temporary name and rename, so concurrent jobs never map a
+    // half-written cache
+    std::string tmp_name = std::string(filename) + ".tmp";
+    FILE* f = fopen(tmp_name.c_str(), "wb");
+    if (!f) {
+        fprintf(stderr, "Cannot write file: %s\n", tmp_name.c_str());
+        return -1;
+    }
+
+    uint64_t pos = 0;
+    int status = write_section(f, &pos, 0, &header, sizeof(header));
+    if (status == 0) status = write_section(f, &pos, header.vertices_offset, mesh->vertices, vertices_bytes);
+    if (status == 0) status = write_section(f, &pos, header.triangles_offset, mesh->triangles, triangles_bytes);
+    if (status == 0) status = write_section(f, &pos, header.uvs_offset, mesh->uvs, uvs_bytes);
+    if (status == 0 && topo) {
+        status = write_section(f, &pos, header.edges_offset, topo->edges, edges_bytes);
+        if (status == 0) status = write_section(f, &pos, header.edge_faces_offset, topo->edge_faces, edges_bytes);
+    }
+
+    if (fclose(f) != 0) status = -1;
+    if (status == 0 && rename(tmp_name.c_str(), filename) != 0) status = -1;
+
+    if (status != 0) {
+        fprintf(stderr, "Failed to write mesh cache: %s\n", filename);
+        remove(tmp_name.c_str());
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Check that the header describes sections inside the file
+ */
+static int validate_header(const MeshCacheHeader* h, size_t file_size) {
+    if (memcmp(h->magic, kMeshCacheMagic, sizeof(h->magic)) != 0) return 0;
+    if (h->version != MESH_CACHE_VERSION) return 0;
+    if (h->endian_tag != MESH_CACHE_ENDIAN_TAG) return 0;
+    if (h->file_size != file_size) return 0;
+    if (h->num_vertices <= 0 || h->num_triangles <= 0 || h->num_edges < 0) return 0;
+
+    uint64_t vertices_end = h->vertices_offset + (uint64_t)h->num_vertices * 3 * sizeof(float);
+    uint64_t triangles_end = h->triangles_offset + (uint64_t)h->num_triangles * 3 * sizeof(int32_t);
+    if (vertices_end > file_size || triangles_end > file_size) return 0;
+
+    if (h->flags & MESH_CACHE_HAS_UVS) {
+        uint64_t uvs_end = h->uvs_offset + (uint64_t)h->num_vertices * 2 * sizeof(float);
+        if (uvs_end > file_size) return 0;
+    }
+    if (h->flags & MESH_CACHE_HAS_TOPOLOGY) {
+        uint64_t edges_bytes = (uint64_t)h->num_edges * 2 * sizeof(int32_t);
+        if (h->edges_offset + edges_bytes > file_size) return 0;
+        if (h->edge_faces_offset + edges_bytes > file_size) return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Check that every stored index points inside the mesh
+ *
+ * One pass over the triangle and edge sections, so a damaged cache is
+ * rejected here instead of crashing whatever indexes through it later.
+ */
+static int validate_contents(const MeshCacheHeader* h, const char* data) {
+    int nv = h->num_vertices;
+    int nf = h->num_triangles;
+
+    const int32_t* tris = (const int32_t*)(data + h->triangles_offset);
+    for (int64_t i = 0; i < (int64_t)nf * 3; i++) {
+        if (tris[i] < 0 || tris[i] >= nv) return 0;
+    }
+
+    if (h->flags & MESH_CACHE_HAS_TOPOLOGY) {
+        const int32_t* edges = (const int32_t*)(data + h->edges_offset);
+        const int32_t* edge_faces = (const int32_t*)(data + h->edge_faces_offset);
+        for (int64_t e = 0; e < h->num_edges; e++) {
+            int32_t v0 = edges[e * 2], v1 = edges[e * 2 + 1];
+            int32_t f0 = edge_faces[e * 2], f1 = edge_faces[e * 2 + 1];
+            if (v0 < 0 || v0 >= nv || v1 < 0 || v1 >= nv) return 0;
+            if (f0 < 0 || f0 >= nf || f1 < -1 || f1 >= nf) return 0;
+        }
+    }
+
+    return 1;
+}
+
+Mesh* load_mesh_cache(const char* filename, TopologyInfo** topo_out) {
+    if (topo_out) *topo_out = NULL;
+    if (!filename) return NULL;
+
+    MappedFile mf;
+    if (map_file(filename, 1, &mf) != 0) return NULL;
+
+    if (mf.size < sizeof(MeshCacheHeader) ||
+        !validate_header((const MeshCacheHeader*)mf.data, mf.size) ||
+        !validate_contents((const MeshCacheHeader*)mf.data, mf.data)) {
+        fprintf(stderr, "Invalid or outdated mesh cache: %s\n", filename);
+        unmap_file(&mf);
+        return NULL;
+    }
+
+    const MeshCacheHeader* h = (const MeshCacheHeader*)mf.data;
+
+    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    mesh->num_vertices = h->num_vertices;
+    mesh->num_triangles = h->num_triangles;
+    mesh->vertices = (float*)(mf.data + h->vertices_offset);
+    mesh->triangles = (int*)(mf.data + h->triangles_offset);
+    mesh->uvs = (h->flags & MESH_CACHE_HAS_UVS) ? (float*)(mf.data + h->uvs_offset) : NULL;
+
+    if (topo_out && (h->flags & MESH_CACHE_HAS_TOPOLOGY)) {
+        // Topology is small next to the mesh and owned by free_topology(),
+        // so it is copied out rather than mapped
+        size_t edges_bytes = (size_t)h->num_edges * 2 * sizeof(int);
+        TopologyInfo* topo = (TopologyInfo*)malloc(sizeof(TopologyInfo));
+        topo->num_edges = h->num_edges;
+        topo->edges = (int*)malloc(edges_bytes);
+        topo->edge_faces = (int*)malloc(edges_bytes);
+        memcpy(topo->edges, mf.data + h->edges_offset, edges_bytes);
+        memcpy(topo->edge_faces, mf.data + h->edge_faces_offset, edges_bytes);
+        topo->vertex_edge_offsets = NULL;
+        topo->vertex_edges = NULL;
+        topo->vertex_face_offsets = NULL;
+        topo->vertex_faces = NULL;
+        topo->face_edges = NULL;
+        if (build_topology_adjacency(mesh, topo) != 0) {
+            free_topology(topo);
+            topo = NULL;
+        }
+        *topo_out = topo;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_mapped_meshes_mutex);
+        g_mapped_meshes[mesh] = mf;
+    }
+
+    return mesh;
+}
+
+int release_mapped_mesh(Mesh* mesh) {
+    MappedFile mf;
+    {
+        std::lock_guard<std::mutex> lock(g_mapped_meshes_mutex);
+        auto it = g_mapped_meshes.find(mesh);
+        if (it == g_mapped_meshes.end()) return 0;
+        mf = it->second;
+        g_mapped_meshes.erase(it);
+    }
+
+    // Callers may have swapped in heap arrays (e.g. new UVs); free those
+    const char* lo = mf.data;
+    const char* hi = mf.data + mf.size;
+    void* arrays[3] = {mesh->vertices, mesh->triangles, mesh->uvs};
+    for (void* p : arrays) {
+        if (p && !((const char*)p >= lo && (const char*)p < hi)) free(p);
+    }
+
+    unmap_file(&mf);
+    free(mesh);
+    return 1;
+}
+
+/**
+ * @brief Modification time in nanoseconds, or -1 if the file is missing
+ */
+static long long file_mtime_ns(const char* filename) {
+    struct stat st;
+    if (stat(filename, &st) != 0) return -1;
+#if defined(__linux__)
+    return (long long)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+    return (long long)st.st_mtimespec.tv_sec * 1000000000LL + st.st_mtimespec.tv_nsec;
+#else
+    return (long long)st.st_mtime * 1000000000LL;
+#endif
+}
+
+Mesh* load_mesh_auto(const char* filename, TopologyInfo** topo_out) {
+    if (topo_out) *topo_out = NULL;
+    if (!filename) return NULL;
+
+    std::string cache_name = std::string(filename) + MESH_CACHE_EXTENSION;
+
+    long long source_mtime = file_mtime_ns(filename);
+    long long cache_mtime = file_mtime_ns(cache_name.c_str());
+
+    if (cache_mtime >= 0 && cache_mtime >= source_mtime) {
+        Mesh* mesh = load_mesh_cache(cache_name.c_str(), topo_out);
+        if (mesh && (!topo_out || *topo_out)) {
+            printf("Loaded %s (cached): %d vertices, %d triangles\n",
+                   filename, mesh->num_vertices, mesh->num_triangles);
+            return mesh;
+        }
+
+        // The cached mesh is good but was written without the topology we
+        // need now: build it from the mapping and rewrite the cache. The
+        // rewrite goes through a rename, so the mapping stays valid.
+        if (mesh) {
+            TopologyInfo* topo = build_topology(mesh);
+            if (topo) {
+                save_mesh_cache(mesh, topo, cache_name.c_str());
+                *topo_out = topo;
+                printf("Loaded %s (cached): %d vertices, %d triangles\n",
+                       filename, mesh->num_vertices, mesh->num_triangles);
+                return mesh;
+            }
+            free_mesh(mesh);
+        }
+    }
+
+    Mesh* mesh = load_mesh(filename);
+    if (!mesh) return NULL;
+
+    TopologyInfo* topo = NULL;
+    if (topo_out) {
+        topo = build_topology(mesh);
+        *topo_out = topo;
+    }
+
+    // A failed cache write only costs the next run a re-parse
+    save_mesh_cache(mesh, topo, cache_name.c_str());
+
+    return mesh;
+}
@@ -1,18 +1,32 @@
 /**
  * @file mesh_io.cpp
- * @brief OBJ file I/O for meshes
+ * @brief OBJ file I/O for meshes (plus binary PLY/STL readers)
  *
  * PROVIDED - Complete implementation
- * Handles loading and saving OBJ files with UVs
+ * Handles loading and saving OBJ files with UVs. The default loader maps the
+ * file and parses it in place on all cores; the original fgets/sscanf
+ * reader is kept as OBJ_LOAD_STDIO (see mesh_io.h). The writer formats into
+ * large buffers with a locale-free shortest round-trip float formatter.
  */
 
 #include "mesh.h"
+#include "mesh_io.h"
+#include "mapped_file.h"
+#include "parallel.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
-Mesh* load_obj(const char* filename) {
+/**
+ * @brief Legacy line-by-line loader (OBJ_LOAD_STDIO)
+ */
+static Mesh* load_obj_stdio(const char* filename) {
     FILE* f = fopen(filename, "r");
     if (!f) {
         fprintf(stderr, "Cannot open file: %s\n", filename);
@@ -90,53 +104,1695 @@ Mesh* load_obj(const char* filename) {
     return mesh;
 }
 
-int save_obj(const Mesh* mesh, const char* filename) {
-    if (!mesh) return -1;
+static inline bool is_blank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+static inline bool is_digit(char c) {
+    return (unsigned)(c - '0') < 10u;
+}
+
+static inline const char* skip_blanks(const char* p, const char* end) {
+    while (p < end && is_blank(*p)) p++;
+    return p;
+}
+
+static inline const char* next_line(const char* p, const char* end) {
+    const char* nl = (const char*)memchr(p, '\n', end - p);
+    return nl ? nl + 1 : end;
+}
+
+/**
+ * @brief Exactly representable powers of ten used by scan_float()
+ */
+static const double kPow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * @brief Fallback for numbers scan_float() cannot convert exactly
+ *        (very long mantissas, huge exponents, inf/nan)
+ */
+static const char* scan_float_slow(const char* p, const char* end, float* out) {
+    char buf[64];
+    size_t n = 0;
+    while (p + n < end && n < sizeof(buf) - 1 &&
+           !is_blank(p[n]) && p[n] != '\n' && p[n] != '\r') {
+        buf[n] = p[n];
+        n++;
+    }
+    buf[n] = '\0';
+
+    char* stop;
+    float value = strtof(buf, &stop);
+    if (stop == buf) return NULL;
+
+    *out = value;
+    return p + (stop - buf);
+}
+
+/**
+ * @brief Parse a decimal float in place (no NUL terminator required)
+ *
+ * Mantissas up to 2^53 with |exponent| <= 22 are converted with a single
+ * exactly-rounded double multiply or divide, which covers everything
+ * typical exporters write. Anything else goes through strtof().
+ *
+ * @return Pointer past the number, or NULL if no number was found
+ */
+static const char* scan_float(const char* p, const char* end, float* out) {
+    p = skip_blanks(p, end);
+    const char* start = p;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+
+    unsigned long long mantissa = 0;
+    int num_digits = 0;
+    int exp10 = 0;
+    bool any_digits = false;
+
+    while (p < end && is_digit(*p)) {
+        any_digits = true;
+        if (num_digits < 19) {
+            mantissa = mantissa * 10 + (unsigned)(*p - '0');
+            if (mantissa) num_digits++;
+        } else {
+            exp10++;
+        }
+        p++;
+    }
+
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && is_digit(*p)) {
+            any_digits = true;
+            if (num_digits < 19) {
+                mantissa = mantissa * 10 + (unsigned)(*p - '0');
+                if (mantissa) num_digits++;
+                exp10--;
+            }
+            p++;
+        }
+    }
+
+    if (!any_digits) return scan_float_slow(start, end, out);
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool exp_negative = false;
+        if (q < end && (*q == '-' || *q == '+')) {
+            exp_negative = (*q == '-');
+            q++;
+        }
+        if (q < end && is_digit(*q)) {
+            int e = 0;
+            while (q < end && is_digit(*q)) {
+                if (e < 10000) e = e * 10 + (*q - '0');
+                q++;
+            }
+            exp10 += exp_negative ? -e : e;
+            p = q;
+        }
+    }
+
+    double value;
+    if (mantissa == 0) {
+        value = 0.0;
+    } else if (mantissa <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22) {
+        value = (double)mantissa;
+        value = (exp10 < 0) ? value / kPow10[-exp10] : value * kPow10[exp10];
+    } else {
+        return scan_float_slow(start, end, out);
+    }
+
+    *out = (float)(negative ? -value : value);
+    return p;
+}
+
+/**
+ * @brief Parse a decimal integer in place
+ * @return Pointer past the number, or NULL if no number was found
+ */
+static const char* scan_int(const char* p, const char* end, long* out) {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+    if (p >= end || !is_digit(*p)) return NULL;
+
+    long value = 0;
+    while (p < end && is_digit(*p)) {
+        if (value < 1000000000000L) value = value * 10 + (*p - '0');
+        p++;
+    }
+
+    *out = negative ? -value : value;
+    return p;
+}
+
+/**
+ * @brief Parse one face corner: v, v/vt, v//vn or v/vt/vn
+ *
+ * @param v Output: vertex index as written (1-based, or negative = relative)
+ * @param vt Output: UV index as written, 0 if absent
+ * @return Pointer past the corner, or NULL if malformed
+ */
+static const char* scan_face_corner(const char* p, const char* end, long* v, long* vt) {
+    p = scan_int(p, end, v);
+    if (!p) return NULL;
+
+    *vt = 0;
+    if (p < end && *p == '/') {
+        p++;
+        if (p < end && *p != '/') {
+            p = scan_int(p, end, vt);
+            if (!p) return NULL;
+        }
+        if (p < end && *p == '/') {
+            long vn;
+            p = scan_int(p + 1, end, &vn);
+            if (!p) return NULL;
+        }
+    }
+
+    if (p < end && !is_blank(*p) && *p != '\n' && *p != '\r') return NULL;
+    return p;
+}
+
+static inline bool is_token_end(const char* p, const char* end) {
+    return p >= end || is_blank(*p) || *p == '\n' || *p == '\r' || *p == '#';
+}
+
+/**
+ * @brief Count the corners on a face line and note whether any has a vt
+ */
+static int count_face_corners(const char* p, const char* end, bool* has_vt) {
+    int corners = 0;
+    for (;;) {
+        p = skip_blanks(p, end);
+        if (is_token_end(p, end)) break;
+
+        corners++;
+        bool first_slash = true;
+        for (; !is_token_end(p, end); p++) {
+            if (*p == '/' && first_slash) {
+                first_slash = false;
+                if (p + 1 < end && (is_digit(p[1]) || p[1] == '-')) *has_vt = true;
+            }
+        }
+    }
+    return corners;
+}
+
+/**
+ * @brief Record counts from the sizing pass
+ */
+struct ObjCounts {
+    size_t vertices;
+    size_t uvs;
+    size_t triangles;       /**< Sum of (corners - 2) over faces */
+    size_t uv_faces;        /**< Faces with vt indices on their corners */
+};
+
+static void count_obj_records(const char* p, const char* end, ObjCounts* counts) {
+    while (p < end) {
+        if (p[0] == 'v') {
+            if (p + 1 < end && is_blank(p[1])) {
+                counts->vertices++;
+            } else if (p + 2 < end && p[1] == 't' && is_blank(p[2])) {
+                counts->uvs++;
+            }
+        } else if (p[0] == 'f' && p + 1 < end && is_blank(p[1])) {
+            bool has_vt = false;
+            int corners = count_face_corners(p + 2, end, &has_vt);
+            if (corners >= 3) {
+                counts->triangles += corners - 2;
+                if (has_vt) counts->uv_faces++;
+            }
+        }
+        p = next_line(p, end);
+    }
+}
+
+/**
+ * @brief A face with more than three corners, first written as a fan
+ */
+struct ObjPolygon {
+    size_t first_triangle;  /**< Slot of the fan's first triangle */
+    int num_corners;
+};
+
+/**
+ * @brief A newline-aligned slice of the mapped file
+ */
+struct ObjChunk {
+    const char* begin;
+    const char* end;
+    ObjCounts counts;       /**< Records found by the sizing pass */
+    ObjCounts offsets;      /**< Exclusive prefix sum of counts over chunks */
+    size_t triangles_written;           /**< Triangles kept (invalid faces dropped) */
+    int invalid_faces;
+    std::vector<ObjPolygon> polygons;   /**< Fans to re-triangulate */
+};
+
+/**
+ * @brief Split [begin, end) into about num_chunks slices at line boundaries
+ */
+static std::vector<ObjChunk> split_obj_chunks(const char* begin, const char* end,
+                                              int num_chunks) {
+    std::vector<ObjChunk> chunks;
+    size_t size = end - begin;
+
+    const char* p = begin;
+    for (int i = 1; i <= num_chunks && p < end; i++) {
+        const char* split = (i == num_chunks) ? end : begin + size / num_chunks * i;
+        if (split < p) split = p;
+        if (split < end) split = next_line(split, end);
+
+        ObjChunk chunk = ObjChunk();
+        chunk.begin = p;
+        chunk.end = split;
+        chunks.push_back(chunk);
+        p = split;
+    }
+
+    return chunks;
+}
+
+/**
+ * @brief Turn an OBJ index into a 0-based one
+ *
+ * @param index 1-based index, or negative for "count from the last record"
+ * @param seen Records of this kind before the current line
+ * @param total Records of this kind in the file
+ * @return 0-based index, or -1 if out of range
+ */
+static inline long resolve_obj_index(long index, size_t seen, size_t total) {
+    long resolved;
+    if (index > 0) {
+        resolved = index - 1;
+    } else if (index < 0) {
+        resolved = (long)seen + index;
+    } else {
+        return -1;
+    }
+    return (resolved >= 0 && (size_t)resolved < total) ? resolved : -1;
+}
+
+/**
+ * @brief Output arrays shared by all chunks
+ */
+struct ObjOutput {
+    float* vertices;        /**< 3 * total.vertices */
+    float* uv_values;       /**< 2 * total.uvs (vt records) */
+    int* triangles;         /**< 3 * total.triangles */
+    int* triangle_uvs;      /**< vt index per corner, -1 if none (NULL if no vt faces) */
+    ObjCounts total;
+};
+
+/**
+ * @brief Parse one chunk, writing records at the chunk's prefix-sum offsets
+ *
+ * Every v/vt line produces a record (missing components read as 0) so
+ * indices always match the file's numbering. Faces with n corners produce
+ * n - 2 triangles, written as a fan for now; those with bad indices are
+ * dropped.
+ */
+static void parse_obj_chunk(ObjChunk* chunk, const ObjOutput* out) {
+    const char* end = chunk->end;
+
+    size_t num_vertices = chunk->offsets.vertices;
+    size_t num_uvs = chunk->offsets.uvs;
+    size_t first_triangle = chunk->offsets.triangles;
+    size_t num_triangles = first_triangle;
+
+    std::vector<int> corner_v;
+    std::vector<int> corner_vt;
+
+    for (const char* p = chunk->begin; p < end; p = next_line(p, end)) {
+        if (p[0] == 'v' && p + 1 < end && is_blank(p[1])) {
+            // Vertex
+            float* v = out->vertices + num_vertices * 3;
+            v[0] = v[1] = v[2] = 0.0f;
+            const char* q = scan_float(p + 2, end, &v[0]);
+            if (q) q = scan_float(q, end, &v[1]);
+            if (q) q = scan_float(q, end, &v[2]);
+            num_vertices++;
+        } else if (p[0] == 'v' && p + 2 < end && p[1] == 't' && is_blank(p[2])) {
+            // UV coordinate
+            float* uv = out->uv_values + num_uvs * 2;
+            uv[0] = uv[1] = 0.0f;
+            const char* q = scan_float(p + 3, end, &uv[0]);
+            if (q) q = scan_float(q, end, &uv[1]);
+            num_uvs++;
+        } else if (p[0] == 'f' && p + 1 < end && is_blank(p[1])) {
+            // Face: any number of corners in any of the four corner forms
+            corner_v.clear();
+            corner_vt.clear();
+            bool valid = true;
+
+            const char* q = p + 2;
+            for (;;) {
+                q = skip_blanks(q, end);
+                if (is_token_end(q, end)) break;
+
+                long v, vt;
+                q = scan_face_corner(q, end, &v, &vt);
+                if (!q) {
+                    valid = false;
+                    break;
+                }
+
+                long vi = resolve_obj_index(v, num_vertices, out->total.vertices);
+                long ti = vt ? resolve_obj_index(vt, num_uvs, out->total.uvs) : -1;
+                if (vi < 0 || (vt && ti < 0)) valid = false;
 
-    FILE* f = fopen(filename, "w");
+                corner_v.push_back((int)vi);
+                corner_vt.push_back((int)ti);
+            }
+
+            int n = (int)corner_v.size();
+            if (n < 3) continue;    // not counted by the sizing pass either
+            if (!valid) {
+                chunk->invalid_faces++;
+                continue;
+            }
+
+            if (n > 3) {
+                ObjPolygon polygon;
+                polygon.first_triangle = num_triangles;
+                polygon.num_corners = n;
+                chunk->polygons.push_back(polygon);
+            }
+
+            for (int k = 1; k + 1 < n; k++) {
+                int* tri = out->triangles + num_triangles * 3;
+                tri[0] = corner_v[0];
+                tri[1] = corner_v[k];
+                tri[2] = corner_v[k + 1];
+                if (out->triangle_uvs) {
+                    int* tri_vt = out->triangle_uvs + num_triangles * 3;
+                    tri_vt[0] = corner_vt[0];
+                    tri_vt[1] = corner_vt[k];
+                    tri_vt[2] = corner_vt[k + 1];
+                }
+                num_triangles++;
+            }
+        }
+    }
+
+    chunk->triangles_written = num_triangles - first_triangle;
+}
+
+/**
+ * @brief Signed area of 2D triangle (a, b, c), times two
+ */
+static inline double cross_2d(const double* a, const double* b, const double* c) {
+    return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+}
+
+/**
+ * @brief Re-triangulate a polygon that was written as a fan, in place
+ *
+ * The polygon is projected onto the plane of its Newell normal. Quads are
+ * split along the shorter diagonal that keeps both halves correctly
+ * oriented; larger polygons are ear-clipped so concave outlines come out
+ * right. Degenerate polygons keep their fan.
+ *
+ * @param vertices Mesh vertex positions
+ * @param tris The polygon's n - 2 triangle slots
+ * @param tri_uvs Matching per-corner vt slots (can be NULL)
+ * @param n Number of corners
+ */
+static void triangulate_polygon(const float* vertices, int* tris, int* tri_uvs, int n) {
+    std::vector<int> v(n), vt(n);
+    v[0] = tris[0];
+    v[1] = tris[1];
+    for (int k = 2; k < n; k++) v[k] = tris[(k - 2) * 3 + 2];
+    if (tri_uvs) {
+        vt[0] = tri_uvs[0];
+        vt[1] = tri_uvs[1];
+        for (int k = 2; k < n; k++) vt[k] = tri_uvs[(k - 2) * 3 + 2];
+    }
+
+    // Newell normal, then drop its dominant axis to project to 2D
+    double normal[3] = {0.0, 0.0, 0.0};
+    for (int i = 0; i < n; i++) {
+        const float* a = vertices + (size_t)v[i] * 3;
+        const float* b = vertices + (size_t)v[(i + 1) % n] * 3;
+        normal[0] += ((double)a[1] - b[1]) * ((double)a[2] + b[2]);
+        normal[1] += ((double)a[2] - b[2]) * ((double)a[0] + b[0]);
+        normal[2] += ((double)a[0] - b[0]) * ((double)a[1] + b[1]);
+    }
+    int axis = 0;
+    if (fabs(normal[1]) > fabs(normal[axis])) axis = 1;
+    if (fabs(normal[2]) > fabs(normal[axis])) axis = 2;
+    if (normal[axis] == 0.0) return;
+
+    int ax0 = (axis + 1) % 3;
+    int ax1 = (axis + 2) % 3;
+    double orientation = normal[axis] > 0 ? 1.0 : -1.0;
+
+    std::vector<double> q(n * 2);
+    for (int i = 0; i < n; i++) {
+        const float* p = vertices + (size_t)v[i] * 3;
+        q[i * 2] = p[ax0];
+        q[i * 2 + 1] = p[ax1];
+    }
+
+    std::vector<int> out;
+    out.reserve((n - 2) * 3);
+
+    if (n == 4) {
+        auto ok = [&](int a, int b, int c) {
+            return orientation * cross_2d(&q[a * 2], &q[b * 2], &q[c * 2]) > 0;
+        };
+        bool split02 = ok(0, 1, 2) && ok(0, 2, 3);
+        bool split13 = ok(1, 2, 3) && ok(1, 3, 0);
+        if (!split02 && !split13) return;
+
+        if (split02 && split13) {
+            const float* p0 = vertices + (size_t)v[0] * 3;
+            const float* p1 = vertices + (size_t)v[1] * 3;
+            const float* p2 = vertices + (size_t)v[2] * 3;
+            const float* p3 = vertices + (size_t)v[3] * 3;
+            double d02 = 0.0, d13 = 0.0;
+            for (int c = 0; c < 3; c++) {
+                d02 += ((double)p0[c] - p2[c]) * ((double)p0[c] - p2[c]);
+                d13 += ((double)p1[c] - p3[c]) * ((double)p1[c] - p3[c]);
+            }
+            split13 = d13 < d02;
+        }
+
+        int order02[6] = {0, 1, 2, 0, 2, 3};
+        int order13[6] = {1, 2, 3, 1, 3, 0};
+        out.assign(split13 ? order13 : order02, (split13 ? order13 : order02) + 6);
+    } else {
+        std::vector<int> ring(n);
+        for (int i = 0; i < n; i++) ring[i] = i;
+
+        while (ring.size() > 3) {
+            int m = (int)ring.size();
+            bool clipped = false;
+
+            for (int i = 0; i < m && !clipped; i++) {
+                int a = ring[(i + m - 1) % m];
+                int b = ring[i];
+                int c = ring[(i + 1) % m];
+                if (orientation * cross_2d(&q[a * 2], &q[b * 2], &q[c * 2]) <= 0) continue;
+
+                bool contains_other = false;
+                for (int j = 0; j < m && !contains_other; j++) {
+                    int o = ring[j];
+                    if (o == a || o == b || o == c) continue;
+                    const double* po = &q[o * 2];
+                    contains_other =
+                        orientation * cross_2d(&q[a * 2], &q[b * 2], po) >= 0 &&
+                        orientation * cross_2d(&q[b * 2], &q[c * 2], po) >= 0 &&
+                        orientation * cross_2d(&q[c * 2], &q[a * 2], po) >= 0;
+                }
+                if (contains_other) continue;
+
+                out.push_back(a);
+                out.push_back(b);
+                out.push_back(c);
+                ring.erase(ring.begin() + i);
+                clipped = true;
+            }
+
+            // Self-intersecting or degenerate outline: fan whatever is left
+            if (!clipped) {
+                for (int k = 1; k + 1 < (int)ring.size(); k++) {
+                    out.push_back(ring[0]);
+                    out.push_back(ring[k]);
+                    out.push_back(ring[k + 1]);
+                }
+                ring.clear();
+            }
+        }
+
+        if (ring.size() == 3) out.insert(out.end(), ring.begin(), ring.end());
+    }
+
+    for (size_t i = 0; i < out.size(); i++) {
+        tris[i] = v[out[i]];
+        if (tri_uvs) tri_uvs[i] = vt[out[i]];
+    }
+}
+
+/**
+ * @brief Close the gaps left by chunks that dropped invalid faces
+ * @return Number of triangles kept
+ */
+static size_t compact_obj_triangles(int* data, const std::vector<ObjChunk>& chunks) {
+    size_t dst = 0;
+    for (const ObjChunk& chunk : chunks) {
+        size_t src = chunk.offsets.triangles;
+        size_t n = chunk.triangles_written;
+        if (dst != src && n > 0) {
+            memmove(data + dst * 3, data + src * 3, n * 3 * sizeof(int));
+        }
+        dst += n;
+    }
+    return dst;
+}
+
+/**
+ * @brief Memory-mapped loader (OBJ_LOAD_MMAP and OBJ_LOAD_PARALLEL)
+ *
+ * The file is cut into newline-aligned chunks. A sizing pass counts
+ * vertices, vt records and triangles per chunk; an exclusive prefix sum
+ * over those counts gives every chunk its first output slot (and the
+ * record counts that negative indices are relative to), so the parse pass
+ * writes straight into the final Mesh arrays and chunks can be processed
+ * in any order. With one thread there is a single chunk and every pass
+ * runs inline.
+ */
+static Mesh* load_obj_mapped(const char* filename, int num_threads) {
+    MappedFile mf;
+    if (map_file(filename, 0, &mf) != 0) {
+        fprintf(stderr, "Cannot open file: %s\n", filename);
+        return NULL;
+    }
+
+    const char* begin = mf.data;
+    const char* end = mf.data + mf.size;
+
+    // Oversplit for load balance, but keep chunks big enough to amortize
+    // thread start-up on small files
+    const size_t min_chunk_bytes = 1 << 20;
+    int num_chunks = 1;
+    if (num_threads > 1) {
+        size_t max_chunks = mf.size / min_chunk_bytes + 1;
+        num_chunks = num_threads * 4;
+        if ((size_t)num_chunks > max_chunks) num_chunks = (int)max_chunks;
+    }
+
+    std::vector<ObjChunk> chunks = split_obj_chunks(begin, end, num_chunks);
+    num_chunks = (int)chunks.size();
+
+    // Pass 1: count records per chunk
+    parallel_for(num_chunks, num_threads, [&](int i) {
+        count_obj_records(chunks[i].begin, chunks[i].end, &chunks[i].counts);
+    });
+
+    ObjCounts total = {0, 0, 0, 0};
+    for (ObjChunk& chunk : chunks) {
+        chunk.offsets = total;
+        total.vertices += chunk.counts.vertices;
+        total.uvs += chunk.counts.uvs;
+        total.triangles += chunk.counts.triangles;
+        total.uv_faces += chunk.counts.uv_faces;
+    }
+
+    if (total.vertices == 0 || total.triangles == 0) {
+        unmap_file(&mf);
+        fprintf(stderr, "Failed to parse OBJ file: %s\n", filename);
+        return NULL;
+    }
+
+    ObjOutput out;
+    out.total = total;
+    out.vertices = (float*)malloc(total.vertices * 3 * sizeof(float));
+    out.uv_values = total.uvs ? (float*)malloc(total.uvs * 2 * sizeof(float)) : NULL;
+    out.triangles = (int*)malloc(total.triangles * 3 * sizeof(int));
+    out.triangle_uvs = (total.uv_faces && total.uvs)
+                           ? (int*)malloc(total.triangles * 3 * sizeof(int))
+                           : NULL;
+
+    // Pass 2: parse every chunk into its slice of the final arrays
+    parallel_for(num_chunks, num_threads, [&](int i) {
+        parse_obj_chunk(&chunks[i], &out);
+    });
+
+    unmap_file(&mf);
+
+    // Every vertex is in place now, so polygons can use their geometry
+    parallel_for(num_chunks, num_threads, [&](int i) {
+        for (const ObjPolygon& polygon : chunks[i].polygons) {
+            size_t offset = polygon.first_triangle * 3;
+            triangulate_polygon(out.vertices, out.triangles + offset,
+                                out.triangle_uvs ? out.triangle_uvs + offset : NULL,
+                                polygon.num_corners);
+        }
+    });
+
+    int invalid_faces = 0;
+    for (const ObjChunk& chunk : chunks) invalid_faces += chunk.invalid_faces;
+    if (invalid_faces > 0) {
+        fprintf(stderr, "Skipped %d faces with invalid indices in %s\n",
+                invalid_faces, filename);
+    }
+
+    size_t num_triangles = compact_obj_triangles(out.triangles, chunks);
+    if (out.triangle_uvs) compact_obj_triangles(out.triangle_uvs, chunks);
+
+    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    mesh->num_vertices = (int)total.vertices;
+    mesh->vertices = out.vertices;
+    mesh->num_triangles = (int)num_triangles;
+    mesh->triangles = out.triangles;
+    mesh->uvs = NULL;
+
+    if (out.triangle_uvs) {
+        // Faces name a vt per corner; Mesh stores one UV per vertex, so each
+        // vertex takes the vt of the first corner that references it
+        mesh->uvs = (float*)calloc(total.vertices * 2, sizeof(float));
+        std::vector<char> assigned(total.vertices, 0);
+        for (size_t i = 0; i < num_triangles * 3; i++) {
+            int v = out.triangles[i];
+            int vt = out.triangle_uvs[i];
+            if (vt < 0 || assigned[v]) continue;
+            mesh->uvs[v * 2] = out.uv_values[vt * 2];
+            mesh->uvs[v * 2 + 1] = out.uv_values[vt * 2 + 1];
+            assigned[v] = 1;
+        }
+        free(out.triangle_uvs);
+        free(out.uv_values);
+    } else if (out.uv_values && total.uvs == total.vertices) {
+        // No per-corner indices: vt i belongs to v i
+        mesh->uvs = out.uv_values;
+    } else {
+        free(out.uv_values);
+    }
+
+    if (mesh->num_triangles == 0) {
+        free_mesh(mesh);
+        fprintf(stderr, "Failed to parse OBJ file: %s\n", filename);
+        return NULL;
+    }
+
+    // Only shrink when invalid faces were dropped
+    if (num_triangles < total.triangles) {
+        mesh->triangles = (int*)realloc(mesh->triangles, num_triangles * 3 * sizeof(int));
+    }
+
+    printf("Loaded %s: %d vertices, %d triangles\n",
+           filename, mesh->num_vertices, mesh->num_triangles);
+
+    return mesh;
+}
+
+void obj_load_default_options(ObjLoadOptions* options) {
+    if (!options) return;
+
+    options->mode = OBJ_LOAD_PARALLEL;
+    options->num_threads = 0;
+}
+
+Mesh* load_obj_ex(const char* filename, const ObjLoadOptions* options) {
+    if (!filename) return NULL;
+
+    ObjLoadOptions defaults;
+    if (!options) {
+        obj_load_default_options(&defaults);
+        options = &defaults;
+    }
+
+    switch (options->mode) {
+        case OBJ_LOAD_STDIO:
+            return load_obj_stdio(filename);
+        case OBJ_LOAD_MMAP:
+            return load_obj_mapped(filename, 1);
+        case OBJ_LOAD_PARALLEL:
+            return load_obj_mapped(filename, resolve_num_threads(options->num_threads));
+        default:
+            fprintf(stderr, "load_obj_ex: Unknown load mode %d\n", options->mode);
+            return NULL;
+    }
+}
+
+Mesh* load_obj(const char* filename) {
+    return load_obj_ex(filename, NULL);
+}
+
+/**
+ * @brief Scalar types that can appear in a PLY header
+ */
+enum PlyType {
+    PLY_INVALID,
+    PLY_INT8,
+    PLY_UINT8,
+    PLY_INT16,
+    PLY_UINT16,
+    PLY_INT32,
+    PLY_UINT32,
+    PLY_FLOAT32,
+    PLY_FLOAT64
+};
+
+static PlyType parse_ply_type(const char* name) {
+    struct { const char* name; PlyType type; } names[] = {
+        {"char", PLY_INT8},     {"int8", PLY_INT8},
+        {"uchar", PLY_UINT8},   {"uint8", PLY_UINT8},
+        {"short", PLY_INT16},   {"int16", PLY_INT16},
+        {"ushort", PLY_UINT16}, {"uint16", PLY_UINT16},
+        {"int", PLY_INT32},     {"int32", PLY_INT32},
+        {"uint", PLY_UINT32},   {"uint32", PLY_UINT32},
+        {"float", PLY_FLOAT32}, {"float32", PLY_FLOAT32},
+        {"double", PLY_FLOAT64}, {"float64", PLY_FLOAT64},
+    };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcmp(name, names[i].name) == 0) return names[i].type;
+    }
+    return PLY_INVALID;
+}
+
+static int ply_type_size(PlyType type) {
+    switch (type) {
+        case PLY_INT8: case PLY_UINT8: return 1;
+        case PLY_INT16: case PLY_UINT16: return 2;
+        case PLY_INT32: case PLY_UINT32: case PLY_FLOAT32: return 4;
+        case PLY_FLOAT64: return 8;
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Read one little-endian scalar (the host must be little-endian)
+ */
+static double read_ply_value(const char* p, PlyType type) {
+    switch (type) {
+        case PLY_INT8: { int8_t v; memcpy(&v, p, 1); return v; }
+        case PLY_UINT8: { uint8_t v; memcpy(&v, p, 1); return v; }
+        case PLY_INT16: { int16_t v; memcpy(&v, p, 2); return v; }
+        case PLY_UINT16: { uint16_t v; memcpy(&v, p, 2); return v; }
+        case PLY_INT32: { int32_t v; memcpy(&v, p, 4); return v; }
+        case PLY_UINT32: { uint32_t v; memcpy(&v, p, 4); return v; }
+        case PLY_FLOAT32: { float v; memcpy(&v, p, 4); return v; }
+        case PLY_FLOAT64: { double v; memcpy(&v, p, 8); return v; }
+        default: return 0.0;
+    }
+}
+
+struct PlyProperty {
+    std::string name;
+    PlyType type;           /**< Scalar type, or list item type */
+    PlyType count_type;     /**< List length type, PLY_INVALID for scalars */
+};
+
+struct PlyElement {
+    std::string name;
+    size_t count;
+    std::vector<PlyProperty> properties;
+};
+
+/**
+ * @brief Parse the text header
+ * @return Pointer to the first byte of binary data, or NULL on error
+ */
+static const char* parse_ply_header(const char* p, const char* end,
+                                    std::vector<PlyElement>* elements) {
+    if (end - p < 4 || memcmp(p, "ply", 3) != 0) return NULL;
+
+    bool binary_le = false;
+    for (p = next_line(p, end); p < end; p = next_line(p, end)) {
+        const char* line_end = (const char*)memchr(p, '\n', end - p);
+        if (!line_end) return NULL;
+
+        char line[256];
+        size_t len = std::min((size_t)(line_end - p), sizeof(line) - 1);
+        memcpy(line, p, len);
+        line[len] = '\0';
+        if (len > 0 && line[len - 1] == '\r') line[len - 1] = '\0';
+
+        char a[64], b[64], c[64], d[64];
+        if (strncmp(line, "end_header", 10) == 0) {
+            return binary_le ? line_end + 1 : NULL;
+        } else if (sscanf(line, "format %63s", a) == 1) {
+            binary_le = (strcmp(a, "binary_little_endian") == 0);
+            if (!binary_le) {
+                fprintf(stderr, "PLY: unsupported format '%s' (need binary_little_endian)\n", a);
+                return NULL;
+            }
+        } else if (sscanf(line, "element %63s %63s", a, b) == 2) {
+            PlyElement element;
+            element.name = a;
+            element.count = (size_t)strtoull(b, NULL, 10);
+            elements->push_back(element);
+        } else if (sscanf(line, "property list %63s %63s %63s", a, b, c) == 3) {
+            if (elements->empty()) return NULL;
+            PlyProperty prop;
+            prop.count_type = parse_ply_type(a);
+            prop.type = parse_ply_type(b);
+            prop.name = c;
+            if (prop.count_type == PLY_INVALID || prop.type == PLY_INVALID) return NULL;
+            elements->back().properties.push_back(prop);
+        } else if (sscanf(line, "property %63s %63s", a, d) == 2) {
+            if (elements->empty()) return NULL;
+            PlyProperty prop;
+            prop.type = parse_ply_type(a);
+            prop.count_type = PLY_INVALID;
+            prop.name = d;
+            if (prop.type == PLY_INVALID) return NULL;
+            elements->back().properties.push_back(prop);
+        }
+        // comment / obj_info lines are ignored
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Step over one property value
+ * @return Pointer past the value, or NULL if the file is truncated
+ */
+static const char* skip_ply_property(const char* p, const char* end, const PlyProperty& prop) {
+    if (!p) return NULL;
+    if (prop.count_type == PLY_INVALID) {
+        p += ply_type_size(prop.type);
+    } else {
+        int count_size = ply_type_size(prop.count_type);
+        if (end - p < count_size) return NULL;
+        long n = (long)read_ply_value(p, prop.count_type);
+        if (n < 0) return NULL;
+        p += count_size + n * ply_type_size(prop.type);
+    }
+    return p > end ? NULL : p;
+}
+
+/**
+ * @brief Step over one record of an element
+ * @return Pointer past the record, or NULL if the file is truncated
+ */
+static const char* skip_ply_record(const char* p, const char* end, const PlyElement& element) {
+    for (const PlyProperty& prop : element.properties) {
+        p = skip_ply_property(p, end, prop);
+        if (!p) return NULL;
+    }
+    return p;
+}
+
+static int find_ply_property(const PlyElement& element, const char* const* names) {
+    for (const char* const* name = names; *name; name++) {
+        for (size_t i = 0; i < element.properties.size(); i++) {
+            if (element.properties[i].name == *name) return (int)i;
+        }
+    }
+    return -1;
+}
+
+Mesh* load_ply(const char* filename) {
+    MappedFile mf;
+    if (map_file(filename, 0, &mf) != 0) {
+        fprintf(stderr, "Cannot open file: %s\n", filename);
+        return NULL;
+    }
+
+    const char* end = mf.data + mf.size;
+    std::vector<PlyElement> elements;
+    const char* p = mf.data ? parse_ply_header(mf.data, end, &elements) : NULL;
+    if (!p) {
+        fprintf(stderr, "Failed to parse PLY header: %s\n", filename);
+        unmap_file(&mf);
+        return NULL;
+    }
+
+    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    mesh->vertices = NULL;
+    mesh->num_vertices = 0;
+    mesh->triangles = NULL;
+    mesh->num_triangles = 0;
+    mesh->uvs = NULL;
+
+    bool ok = true;
+    std::vector<ObjPolygon> polygons;
+
+    for (const PlyElement& element : elements) {
+        if (!ok) break;
+
+        if (element.name == "vertex") {
+            static const char* const x_names[] = {"x", NULL};
+            static const char* const y_names[] = {"y", NULL};
+            static const char* const z_names[] = {"z", NULL};
+            static const char* const u_names[] = {"u", "s", "texture_u", NULL};
+            static const char* const v_names[] = {"v", "t", "texture_v", NULL};
+            int ix = find_ply_property(element, x_names);
+            int iy = find_ply_property(element, y_names);
+            int iz = find_ply_property(element, z_names);
+            int iu = find_ply_property(element, u_names);
+            int iv = find_ply_property(element, v_names);
+
+            // Vertex records must be fixed-size for the direct paths below
+            std::vector<int> offsets;
+            int stride = 0;
+            for (const PlyProperty& prop : element.properties) {
+                if (prop.count_type != PLY_INVALID) stride = -1;
+                if (stride < 0) break;
+                offsets.push_back(stride);
+                stride += ply_type_size(prop.type);
+            }
+
+            if (ix < 0 || iy < 0 || iz < 0 || stride <= 0 ||
+                (size_t)(end - p) < element.count * stride) {
+                ok = false;
+                break;
+            }
+
+            size_t n = element.count;
+            mesh->num_vertices = (int)n;
+            mesh->vertices = (float*)malloc(n * 3 * sizeof(float));
+            if (iu >= 0 && iv >= 0) mesh->uvs = (float*)malloc(n * 2 * sizeof(float));
+
+            const PlyProperty* props = element.properties.data();
+            bool packed_xyz = stride == 12 && ix == 0 && iy == 1 && iz == 2 &&
+                              props[0].type == PLY_FLOAT32 &&
+                              props[1].type == PLY_FLOAT32 &&
+                              props[2].type == PLY_FLOAT32;
+
+            if (packed_xyz) {
+                // The common "float x, y, z" layout is the Mesh layout
+                memcpy(mesh->vertices, p, n * 12);
+            } else {
+                for (size_t i = 0; i < n; i++) {
+                    const char* rec = p + i * stride;
+                    mesh->vertices[i * 3] = (float)read_ply_value(rec + offsets[ix], props[ix].type);
+                    mesh->vertices[i * 3 + 1] = (float)read_ply_value(rec + offsets[iy], props[iy].type);
+                    mesh->vertices[i * 3 + 2] = (float)read_ply_value(rec + offsets[iz], props[iz].type);
+                }
+            }
+            if (mesh->uvs) {
+                for (size_t i = 0; i < n; i++) {
+                    const char* rec = p + i * stride;
+                    mesh->uvs[i * 2] = (float)read_ply_value(rec + offsets[iu], props[iu].type);
+                    mesh->uvs[i * 2 + 1] = (float)read_ply_value(rec + offsets[iv], props[iv].type);
+                }
+            }
+            p += n * stride;
+        } else if (element.name == "face") {
+            static const char* const index_names[] = {"vertex_indices", "vertex_index", NULL};
+            int il = find_ply_property(element, index_names);
+            if (il < 0 || element.properties[il].count_type == PLY_INVALID) {
+                ok = false;
+                break;
+            }
+            const PlyProperty& list = element.properties[il];
+            int count_size = ply_type_size(list.count_type);
+            int index_size = ply_type_size(list.type);
+
+            // Size the triangle array from the list lengths, then fill it
+            const char* faces_begin = p;
+            size_t num_slots = 0;
+            for (size_t f = 0; f < element.count && p; f++) {
+                const char* rec = p;
+                for (int k = 0; k < il; k++) {
+                    rec = skip_ply_property(rec, end, element.properties[k]);
+                }
+                if (rec && end - rec >= count_size) {
+                    long n = (long)read_ply_value(rec, list.count_type);
+                    if (n >= 3) num_slots += n - 2;
+                }
+                p = skip_ply_record(p, end, element);
+            }
+            if (!p) {
+                ok = false;
+                break;
+            }
+
+            mesh->triangles = (int*)malloc((num_slots ? num_slots : 1) * 3 * sizeof(int));
+            std::vector<int> corners;
+            size_t invalid = 0;
+            const char* rec = faces_begin;
+            for (size_t f = 0; f < element.count; f++) {
+                const char* q = rec;
+                for (int k = 0; k < il; k++) {
+                    q = skip_ply_property(q, end, element.properties[k]);
+                }
+                long n = (long)read_ply_value(q, list.count_type);
+                q += count_size;
+
+                corners.clear();
+                bool valid = true;
+                for (long k = 0; k < n; k++) {
+                    long index = (long)read_ply_value(q + k * index_size, list.type);
+                    if (index < 0 || index >= mesh->num_vertices) valid = false;
+                    corners.push_back((int)index);
+                }
+                rec = skip_ply_record(rec, end, element);
+
+                if (n < 3) continue;
+                if (!valid) {
+                    invalid++;
+                    continue;
+                }
+                if (n > 3) {
+                    ObjPolygon polygon;
+                    polygon.first_triangle = mesh->num_triangles;
+                    polygon.num_corners = (int)n;
+                    polygons.push_back(polygon);
+                }
+                for (long k = 1; k + 1 < n; k++) {
+                    int* tri = mesh->triangles + (size_t)mesh->num_triangles * 3;
+                    tri[0] = corners[0];
+                    tri[1] = corners[k];
+                    tri[2] = corners[k + 1];
+                    mesh->num_triangles++;
+                }
+            }
+            if (invalid > 0) {
+                fprintf(stderr, "Skipped %zu faces with invalid indices in %s\n", invalid, filename);
+            }
+        } else {
+            for (size_t i = 0; i < element.count && p; i++) {
+                p = skip_ply_record(p, end, element);
+            }
+            if (!p) ok = false;
+        }
+    }
+
+    unmap_file(&mf);
+
+    if (!ok || mesh->num_vertices == 0 || mesh->num_triangles == 0) {
+        free_mesh(mesh);
+        fprintf(stderr, "Failed to parse PLY file: %s\n", filename);
+        return NULL;
+    }
+
+    for (const ObjPolygon& polygon : polygons) {
+        triangulate_polygon(mesh->vertices, mesh->triangles + polygon.first_triangle * 3,
+                            NULL, polygon.num_corners);
+    }
+
+    printf("Loaded %s: %d vertices, %d triangles\n",
+           filename, mesh->num_vertices, mesh->num_triangles);
+
+    return mesh;
+}
+
+/**
+ * @brief Hash of a vertex position's bit pattern
+ */
+static inline uint64_t hash_position(const uint32_t bits[3]) {
+    uint64_t h = bits[0] * 0x9E3779B97F4A7C15ULL;
+    h ^= (h >> 29) ^ (bits[1] * 0xC2B2AE3D27D4EB4FULL);
+    h ^= (h >> 31) ^ (bits[2] * 0x165667B19E3779F9ULL);
+    h ^= h >> 32;
+    return h;
+}
+
+Mesh* load_stl(const char* filename) {
+    MappedFile mf;
+    if (map_file(filename, 0, &mf) != 0) {
+        fprintf(stderr, "Cannot open file: %s\n", filename);
+        return NULL;
+    }
+
+    uint32_t num_facets = 0;
+    if (mf.size >= 84) memcpy(&num_facets, mf.data + 80, sizeof(num_facets));
+
+    // Some exporters pad the file past the last facet; the tail is ignored
+    if (mf.size < 84 || mf.size < 84 + (size_t)num_facets * 50 || num_facets == 0) {
+        if (mf.size >= 5 && memcmp(mf.data, "solid", 5) == 0) {
+            fprintf(stderr, "ASCII STL is not supported: %s\n", filename);
+        } else {
+            fprintf(stderr, "Failed to parse STL file: %s\n", filename);
+        }
+        unmap_file(&mf);
+        return NULL;
+    }
+
+    size_t num_corners = (size_t)num_facets * 3;
+
+    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    mesh->num_triangles = (int)num_facets;
+    mesh->triangles = (int*)malloc(num_corners * sizeof(int));
+    mesh->vertices = (float*)malloc(num_corners * 3 * sizeof(float));
+    mesh->uvs = NULL;
+
+    // STL repeats every corner; weld exact duplicates through an
+    // open-addressing table of vertex indices
+    size_t capacity = 1;
+    while (capacity < num_corners * 2) capacity <<= 1;
+    std::vector<int> table(capacity, -1);
+    uint32_t* vertex_bits = (uint32_t*)mesh->vertices;
+
+    int num_vertices = 0;
+    for (size_t i = 0; i < num_corners; i++) {
+        // 50-byte facet: normal, 3 corners, attribute count
+        const char* src = mf.data + 84 + (i / 3) * 50 + 12 + (i % 3) * 12;
+        float pos[3];
+        memcpy(pos, src, sizeof(pos));
+        for (int c = 0; c < 3; c++) {
+            if (pos[c] == 0.0f) pos[c] = 0.0f;     // -0 welds with +0
+        }
+        uint32_t bits[3];
+        memcpy(bits, pos, sizeof(bits));
+
+        size_t slot = hash_position(bits) & (capacity - 1);
+        for (;;) {
+            int v = table[slot];
+            if (v < 0) {
+                memcpy(vertex_bits + (size_t)num_vertices * 3, bits, sizeof(bits));
+                table[slot] = v = num_vertices++;
+                mesh->triangles[i] = v;
+                break;
+            }
+            if (memcmp(vertex_bits + (size_t)v * 3, bits, sizeof(bits)) == 0) {
+                mesh->triangles[i] = v;
+                break;
+            }
+            slot = (slot + 1) & (capacity - 1);
+        }
+    }
+
+    unmap_file(&mf);
+
+    mesh->num_vertices = num_vertices;
+    mesh->vertices = (float*)realloc(mesh->vertices, (size_t)num_vertices * 3 * sizeof(float));
+
+    printf("Loaded %s: %d vertices, %d triangles\n",
+           filename, mesh->num_vertices, mesh->num_triangles);
+
+    return mesh;
+}
+
+/**
+ * @brief Case-insensitive check of a filename's extension
+ */
+static bool has_extension(const char* filename, const char* ext) {
+    size_t n = strlen(filename);
+    size_t m = strlen(ext);
+    if (n < m) return false;
+    for (size_t i = 0; i < m; i++) {
+        char a = filename[n - m + i];
+        if (a >= 'A' && a <= 'Z') a = (char)(a - 'A' + 'a');
+        if (a != ext[i]) return false;
+    }
+    return true;
+}
+
+Mesh* load_mesh(const char* filename) {
+    if (!filename) return NULL;
+
+    if (has_extension(filename, ".ply")) return load_ply(filename);
+    if (has_extension(filename, ".stl")) return load_stl(filename);
+    return load_obj(filename);
+}
+
+/**
+ * @brief Append a decimal integer
+ */
+static char* format_int(char* out, long long value) {
+    if (value < 0) {
+        *out++ = '-';
+        value = -value;
+    }
+
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    while (n > 0) *out++ = digits[--n];
+    return out;
+}
+
+/**
+ * @brief 2^(bits(5^q) + 58) / 5^q rounded up, q = 0..31, for shortest_float()
+ */
+static const uint64_t kFloatPow5Inv[32] = {
+    0x0800000000000001ull, 0x0666666666666667ull, 0x051eb851eb851eb9ull,
+    0x04189374bc6a7efaull, 0x068db8bac710cb2aull, 0x053e2d6238da3c22ull,
+    0x0431bde82d7b634eull, 0x06b5fca6af2bd216ull, 0x055e63b88c230e78ull,
+    0x044b82fa09b5a52dull, 0x06df37f675ef6eaeull, 0x057f5ff85e592558ull,
+    0x0465e6604b7a8447ull, 0x0709709a125da071ull, 0x05a126e1a84ae6c1ull,
+    0x0480ebe7b9d58567ull, 0x0734aca5f6226f0bull, 0x05c3bd5191b525a3ull,
+    0x049c97747490eae9ull, 0x0760f253edb4ab0eull, 0x05e72843249088d8ull,
+    0x04b8ed0283a6d3e0ull, 0x078e480405d7b966ull, 0x060b6cd004ac9452ull,
+    0x04d5f0a66a23a9dbull, 0x07bcb43d769f762bull, 0x063090312bb2c4efull,
+    0x04f3a68dbc8f03f3ull, 0x07ec3daf94180651ull, 0x065697bfa9acd1daull,
+    0x051212ffbaf0a7e2ull, 0x040e7599625a1fe8ull,
+};
+
+/**
+ * @brief 5^i scaled to its top 61 bits, i = 0..47, for shortest_float()
+ */
+static const uint64_t kFloatPow5[48] = {
+    0x1000000000000000ull, 0x1400000000000000ull, 0x1900000000000000ull,
+    0x1f40000000000000ull, 0x1388000000000000ull, 0x186a000000000000ull,
+    0x1e84800000000000ull, 0x1312d00000000000ull, 0x17d7840000000000ull,
+    0x1dcd650000000000ull, 0x12a05f2000000000ull, 0x174876e800000000ull,
+    0x1d1a94a200000000ull, 0x12309ce540000000ull, 0x16bcc41e90000000ull,
+    0x1c6bf52634000000ull, 0x11c37937e0800000ull, 0x16345785d8a00000ull,
+    0x1bc16d674ec80000ull, 0x1158e460913d0000ull, 0x15af1d78b58c4000ull,
+    0x1b1ae4d6e2ef5000ull, 0x10f0cf064dd59200ull, 0x152d02c7e14af680ull,
+    0x1a784379d99db420ull, 0x108b2a2c28029094ull, 0x14adf4b7320334b9ull,
+    0x19d971e4fe8401e7ull, 0x1027e72f1f128130ull, 0x1431e0fae6d7217cull,
+    0x193e5939a08ce9dbull, 0x1f8def8808b02452ull, 0x13b8b5b5056e16b3ull,
+    0x18a6e32246c99c60ull, 0x1ed09bead87c0378ull, 0x13426172c74d822bull,
+    0x1812f9cf7920e2b6ull, 0x1e17b84357691b64ull, 0x12ced32a16a1b11eull,
+    0x178287f49c4a1d66ull, 0x1d6329f1c35ca4bfull, 0x125dfa371a19e6f7ull,
+    0x16f578c4e0a060b5ull, 0x1cb2d6f618c878e3ull, 0x11efc659cf7d4b8dull,
+    0x166bb7f0435c9e71ull, 0x1c06a5ec5433c60dull, 0x118427b3b4a05bc8ull,
+};
+
+#define FLOAT_POW5_INV_BITS 59
+#define FLOAT_POW5_BITS 61
+
+/** @brief Bits in 5^e (1 for e = 0), valid for 0 <= e <= 3528 */
+static inline int pow5_bits(int e) { return (int)(((uint32_t)e * 1217359) >> 19) + 1; }
+/** @brief floor(log10(2^e)), valid for 0 <= e <= 1650 */
+static inline int log10_pow2(int e) { return (int)(((uint32_t)e * 78913) >> 18); }
+/** @brief floor(log10(5^e)), valid for 0 <= e <= 2620 */
+static inline int log10_pow5(int e) { return (int)(((uint32_t)e * 732923) >> 20); }
+
+static inline bool multiple_of_pow5(uint32_t value, int p) {
+    int count = 0;
+    while (value % 5 == 0) {
+        value /= 5;
+        count++;
+    }
+    return count >= p;
+}
+
+static inline bool multiple_of_pow2(uint32_t value, int p) {
+    return (value & ((1u << p) - 1)) == 0;
+}
+
+/** @brief (m * factor) >> shift, for shift > 32 */
+static inline uint32_t mul_shift(uint32_t m, uint64_t factor, int shift) {
+    uint64_t low = (uint64_t)m * (uint32_t)factor;
+    uint64_t high = (uint64_t)m * (uint32_t)(factor >> 32);
+    return (uint32_t)(((low >> 32) + high) >> (shift - 32));
+}
+
+/**
+ * @brief Shortest decimal digits * 10^exponent that read back as value
+ *
+ * Ryu (Adams, PLDI 2018) for positive finite floats: the rounding
+ * interval [mm, mp] around value is scaled by a power of ten in exact
+ * integer arithmetic, then digits are dropped while the interval still
+ * holds a shorter number. Bounds count as inside when the mantissa is
+ * even, matching round-half-even parsing. Among the shortest candidates
+ * the one nearest to value wins.
+ */
+static uint32_t shortest_float(float value, int* exponent) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t ieee_mantissa = bits & ((1u << 23) - 1);
+    int ieee_exponent = (int)((bits >> 23) & 0xff);
+
+    // value = m2 * 2^e2, with two extra bits for the interval bounds
+    int e2;
+    uint32_t m2;
+    if (ieee_exponent == 0) {
+        e2 = 1 - 127 - 23 - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = ieee_exponent - 127 - 23 - 2;
+        m2 = (1u << 23) | ieee_mantissa;
+    }
+    bool accept_bounds = (m2 & 1) == 0;
+
+    // The gap below a power of two is half the gap above it
+    uint32_t mv = 4 * m2;
+    uint32_t mp = 4 * m2 + 2;
+    uint32_t mm_shift = (ieee_mantissa != 0 || ieee_exponent <= 1) ? 1 : 0;
+    uint32_t mm = 4 * m2 - 1 - mm_shift;
+
+    // vr, vp, vm = mv, mp, mm * 2^e2 / 10^e10
+    uint32_t vr, vp, vm;
+    int e10;
+    bool vm_trailing_zeros = false;
+    bool vr_trailing_zeros = false;
+    uint32_t last_removed_digit = 0;
+    if (e2 >= 0) {
+        int q = log10_pow2(e2);
+        e10 = q;
+        int k = FLOAT_POW5_INV_BITS + pow5_bits(q) - 1;
+        int i = -e2 + q + k;
+        vr = mul_shift(mv, kFloatPow5Inv[q], i);
+        vp = mul_shift(mp, kFloatPow5Inv[q], i);
+        vm = mul_shift(mm, kFloatPow5Inv[q], i);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            // The loop below removes no digit, so find the one q - 1 gives
+            int l = FLOAT_POW5_INV_BITS + pow5_bits(q - 1) - 1;
+            last_removed_digit = mul_shift(mv, kFloatPow5Inv[q - 1], -e2 + q - 1 + l) % 10;
+        }
+        if (q <= 9) {
+            // Only one of mp, mv, mm can be a multiple of 5
+            if (mv % 5 == 0) {
+                vr_trailing_zeros = multiple_of_pow5(mv, q);
+            } else if (accept_bounds) {
+                vm_trailing_zeros = multiple_of_pow5(mm, q);
+            } else {
+                vp -= multiple_of_pow5(mp, q) ? 1 : 0;
+            }
+        }
+    } else {
+        int q = log10_pow5(-e2);
+        e10 = q + e2;
+        int i = -e2 - q;
+        int k = pow5_bits(i) - FLOAT_POW5_BITS;
+        int j = q - k;
+        vr = mul_shift(mv, kFloatPow5[i], j);
+        vp = mul_shift(mp, kFloatPow5[i], j);
+        vm = mul_shift(mm, kFloatPow5[i], j);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            j = q - 1 - (pow5_bits(i + 1) - FLOAT_POW5_BITS);
+            last_removed_digit = mul_shift(mv, kFloatPow5[i + 1], j) % 10;
+        }
+        if (q <= 1) {
+            // mv has at least two trailing zero bits
+            vr_trailing_zeros = true;
+            if (accept_bounds) {
+                vm_trailing_zeros = mm_shift == 1;
+            } else {
+                vp--;
+            }
+        } else if (q < 31) {
+            vr_trailing_zeros = multiple_of_pow2(mv, q - 1);
+        }
+    }
+
+    // Drop digits while a shorter number still fits between vm and vp
+    int removed = 0;
+    uint32_t output;
+    if (vm_trailing_zeros || vr_trailing_zeros) {
+        // Rare: the bounds or value are exact, which decides the ties
+        while (vp / 10 > vm / 10) {
+            vm_trailing_zeros &= vm % 10 == 0;
+            vr_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        if (vm_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = vr % 10;
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        if (vr_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0) {
+            // Exactly halfway: round to even
+            last_removed_digit = 4;
+        }
+        output = vr + (((vr == vm && (!accept_bounds || !vm_trailing_zeros)) ||
+                        last_removed_digit >= 5) ? 1 : 0);
+    } else {
+        while (vp / 10 > vm / 10) {
+            last_removed_digit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        output = vr + ((vr == vm || last_removed_digit >= 5) ? 1 : 0);
+    }
+
+    *exponent = e10 + removed;
+    return output;
+}
+
+/**
+ * @brief Append the shortest decimal that reads back as exactly value
+ *
+ * Digits come from shortest_float(), so they are the fewest that
+ * round-trip and, among those, the nearest to value. Output never depends
+ * on the C locale.
+ */
+static char* format_float(char* out, float value) {
+    if (value != value) {
+        memcpy(out, "nan", 3);
+        return out + 3;
+    }
+    if (value < 0 || (value == 0 && signbit(value))) {
+        *out++ = '-';
+        value = -value;
+    }
+    if (value == 0) {
+        *out++ = '0';
+        return out;
+    }
+    if (isinf(value)) {
+        memcpy(out, "inf", 3);
+        return out + 3;
+    }
+
+    int exponent;
+    uint32_t mantissa = shortest_float(value, &exponent);
+    int num_digits = 1;
+    for (uint32_t m = mantissa; m >= 10; m /= 10) num_digits++;
+    int e10 = exponent + num_digits - 1;
+
+    while (num_digits > 1 && mantissa % 10 == 0) {
+        mantissa /= 10;
+        num_digits--;
+    }
+
+    char digits[20];
+    for (int i = num_digits - 1; i >= 0; i--) {
+        digits[i] = (char)('0' + mantissa % 10);
+        mantissa /= 10;
+    }
+
+    if (e10 >= 0 && e10 < 9) {
+        // ddd.ddd or ddd000
+        int int_digits = e10 + 1;
+        for (int i = 0; i < int_digits; i++) {
+            *out++ = (i < num_digits) ? digits[i] : '0';
+        }
+        if (num_digits > int_digits) {
+            *out++ = '.';
+            for (int i = int_digits; i < num_digits; i++) *out++ = digits[i];
+        }
+    } else if (e10 < 0 && e10 >= -5) {
+        // 0.000ddd
+        *out++ = '0';
+        *out++ = '.';
+        for (int i = -1; i > e10; i--) *out++ = '0';
+        for (int i = 0; i < num_digits; i++) *out++ = digits[i];
+    } else {
+        // d.ddde+XX
+        *out++ = digits[0];
+        if (num_digits > 1) {
+            *out++ = '.';
+            for (int i = 1; i < num_digits; i++) *out++ = digits[i];
+        }
+        *out++ = 'e';
+        out = format_int(out, e10);
+    }
+
+    return out;
+}
+
+/**
+ * @brief Longest line any OBJ record below can produce
+ */
+#define OBJ_MAX_LINE 160
+
+/**
+ * @brief Record kinds, written in this order
+ */
+enum ObjSection {
+    OBJ_SECTION_VERTICES,
+    OBJ_SECTION_UVS,
+    OBJ_SECTION_FACES
+};
+
+/**
+ * @brief A contiguous range of records formatted as one unit of work
+ */
+struct ObjWriteTask {
+    int section;
+    int begin;
+    int end;
+};
+
+/**
+ * @brief Everything needed to format any record of the output
+ */
+struct ObjWriteContext {
+    const Mesh* mesh;
+    const float* uvs;           /**< vt records (mesh->uvs or deduplicated) */
+    const int* uv_index;        /**< Per-vertex vt index, NULL for identity */
+};
+
+/**
+ * @brief Format records [task.begin, task.end) of one section into buf
+ */
+static void format_obj_task(const ObjWriteContext* ctx, const ObjWriteTask& task,
+                            std::vector<char>* buf) {
+    buf->resize((size_t)(task.end - task.begin) * OBJ_MAX_LINE);
+    char* out = buf->data();
+
+    const Mesh* mesh = ctx->mesh;
+    for (int i = task.begin; i < task.end; i++) {
+        if (task.section == OBJ_SECTION_VERTICES) {
+            const float* p = mesh->vertices + (size_t)i * 3;
+            *out++ = 'v';
+            *out++ = ' ';
+            out = format_float(out, p[0]);
+            *out++ = ' ';
+            out = format_float(out, p[1]);
+            *out++ = ' ';
+            out = format_float(out, p[2]);
+        } else if (task.section == OBJ_SECTION_UVS) {
+            const float* uv = ctx->uvs + (size_t)i * 2;
+            *out++ = 'v';
+            *out++ = 't';
+            *out++ = ' ';
+            out = format_float(out, uv[0]);
+            *out++ = ' ';
+            out = format_float(out, uv[1]);
+        } else {
+            const int* tri = mesh->triangles + (size_t)i * 3;
+            *out++ = 'f';
+            for (int k = 0; k < 3; k++) {
+                *out++ = ' ';
+                out = format_int(out, (long long)tri[k] + 1);
+                if (ctx->uvs) {
+                    int vt = ctx->uv_index ? ctx->uv_index[tri[k]] : tri[k];
+                    *out++ = '/';
+                    out = format_int(out, (long long)vt + 1);
+                }
+            }
+        }
+        *out++ = '\n';
+    }
+
+    buf->resize(out - buf->data());
+}
+
+/**
+ * @brief Collapse identical UV pairs
+ *
+ * @param mesh Mesh with UVs
+ * @param unique_out Output: distinct (u, v) pairs in first-use order
+ * @param index_out Output: per-vertex index into unique_out
+ */
+static void dedup_uvs(const Mesh* mesh, std::vector<float>* unique_out,
+                      std::vector<int>* index_out) {
+    std::unordered_map<unsigned long long, int> seen;
+    seen.reserve(mesh->num_vertices);
+    index_out->resize(mesh->num_vertices);
+
+    for (int i = 0; i < mesh->num_vertices; i++) {
+        float u = mesh->uvs[i * 2];
+        float v = mesh->uvs[i * 2 + 1];
+        // Fold -0 into +0 so they share a record
+        if (u == 0.0f) u = 0.0f;
+        if (v == 0.0f) v = 0.0f;
+
+        unsigned int ubits, vbits;
+        memcpy(&ubits, &u, sizeof(ubits));
+        memcpy(&vbits, &v, sizeof(vbits));
+        unsigned long long key = ((unsigned long long)ubits << 32) | vbits;
+
+        auto inserted = seen.insert(std::make_pair(key, (int)seen.size()));
+        if (inserted.second) {
+            unique_out->push_back(u);
+            unique_out->push_back(v);
+        }
+        (*index_out)[i] = inserted.first->second;
+    }
+}
+
+void obj_save_default_options(ObjSaveOptions* options) {
+    if (!options) return;
+
+    options->dedup_uvs = 0;
+    options->num_threads = 0;
+}
+
+int save_obj_ex(const Mesh* mesh, const char* filename, const ObjSaveOptions* options) {
+    if (!mesh || !filename) return -1;
+
+    ObjSaveOptions defaults;
+    if (!options) {
+        obj_save_default_options(&defaults);
+        options = &defaults;
+    }
+
+    FILE* f = fopen(filename, "wb");
     if (!f) {
         fprintf(stderr, "Cannot write file: %s\n", filename);
         return -1;
     }
 
-    // Write vertices
-    for (int i = 0; i < mesh->num_vertices; i++) {
-        fprintf(f, "v %f %f %f\n",
-                mesh->vertices[i*3],
-                mesh->vertices[i*3+1],
-                mesh->vertices[i*3+2]);
+    ObjWriteContext ctx;
+    ctx.mesh = mesh;
+    ctx.uvs = mesh->uvs;
+    ctx.uv_index = NULL;
+
+    std::vector<float> unique_uvs;
+    std::vector<int> uv_index;
+    int num_uv_records = mesh->uvs ? mesh->num_vertices : 0;
+    if (mesh->uvs && options->dedup_uvs) {
+        dedup_uvs(mesh, &unique_uvs, &uv_index);
+        ctx.uvs = unique_uvs.data();
+        ctx.uv_index = uv_index.data();
+        num_uv_records = (int)(unique_uvs.size() / 2);
     }
 
-    // Write UVs if present
-    if (mesh->uvs) {
-        for (int i = 0; i < mesh->num_vertices; i++) {
-            fprintf(f, "vt %f %f\n",
-                    mesh->uvs[i*2],
-                    mesh->uvs[i*2+1]);
+    // Fixed-size tasks keep every buffer around a few MB regardless of mesh size
+    const int records_per_task = 32768;
+    std::vector<ObjWriteTask> tasks;
+    int section_sizes[3] = {mesh->num_vertices, num_uv_records, mesh->num_triangles};
+    for (int section = 0; section < 3; section++) {
+        for (int begin = 0; begin < section_sizes[section]; begin += records_per_task) {
+            ObjWriteTask task;
+            task.section = section;
+            task.begin = begin;
+            task.end = begin + records_per_task;
+            if (task.end > section_sizes[section]) task.end = section_sizes[section];
+            tasks.push_back(task);
         }
     }
 
-    // Write faces
-    for (int i = 0; i < mesh->num_triangles; i++) {
-        int v0 = mesh->triangles[i*3] + 1;
-        int v1 = mesh->triangles[i*3+1] + 1;
-        int v2 = mesh->triangles[i*3+2] + 1;
+    // Format a batch of tasks in parallel, then write the batch in order
+    int num_threads = resolve_num_threads(options->num_threads);
+    int batch_size = num_threads > 1 ? num_threads * 2 : 1;
+    std::vector<std::vector<char> > buffers(batch_size);
 
-        if (mesh->uvs) {
-            fprintf(f, "f %d/%d %d/%d %d/%d\n",
-                    v0, v0, v1, v1, v2, v2);
-        } else {
-            fprintf(f, "f %d %d %d\n", v0, v1, v2);
+    int status = 0;
+    for (size_t first = 0; first < tasks.size() && status == 0; first += batch_size) {
+        int count = (int)std::min(tasks.size() - first, (size_t)batch_size);
+
+        parallel_for(count, num_threads, [&](int i) {
+            format_obj_task(&ctx, tasks[first + i], &buffers[i]);
+        });
+
+        for (int i = 0; i < count; i++) {
+            const std::vector<char>& buf = buffers[i];
+            if (!buf.empty() && fwrite(buf.data(), 1, buf.size(), f) != buf.size()) {
+                status = -1;
+                break;
+            }
         }
     }
 
-    fclose(f);
+    if (fclose(f) != 0) status = -1;
+    if (status != 0) {
+        fprintf(stderr, "Failed to write file: %s\n", filename);
+        return -1;
+    }
+
     printf("Saved %s\n", filename);
     return 0;
 }
 
+int save_obj(const Mesh* mesh, const char* filename) {
+    return save_obj_ex(mesh, filename, NULL);
+}
+
 void free_mesh(Mesh* mesh) {
     if (!mesh) return;
+    if (release_mapped_mesh(mesh)) return;
 
     if (mesh->vertices) free(mesh->vertices);
     if (mesh->triangles) free(mesh->triangles);
@@ -0,0 +1,288 @@
+/**
+ * @file mesh_repair.cpp
+ * @brief Vertex welding and triangle clean-up
+ *
+ * Grid-hashed welding followed by removal of collapsed and repeated faces.
+ *
+ * Welding keeps a hash table from grid cell to the kept ("representative")
+ * vertices inside it, chained through a next array. Each vertex probes its
+ * own cell and the 26 around it, which covers everything within epsilon
+ * because cells are epsilon wide. Only representatives are stored, and cell
+ * coordinates are recomputed from positions, so the whole pass needs about
+ * 12 bytes per vertex on top of the output mesh.
+ */
+
+#include "mesh_repair.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief Integer grid cell of a vertex
+ */
+struct WeldCell {
+    int64_t x, y, z;
+};
+
+static inline int weld_cells_equal(const WeldCell& a, const WeldCell& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+static inline uint64_t hash_cell(const WeldCell& c) {
+    uint64_t h = (uint64_t)c.x * 0x9E3779B97F4A7C15ULL;
+    h ^= (h >> 29) ^ ((uint64_t)c.y * 0xC2B2AE3D27D4EB4FULL);
+    h ^= (h >> 31) ^ ((uint64_t)c.z * 0x165667B19E3779F9ULL);
+    h ^= h >> 32;
+    return h;
+}
+
+/**
+ * @brief Grid coordinate along one axis
+ *
+ * With epsilon = 0 the cell is the float's bit pattern (with -0 folded
+ * into +0), so only identical positions share a cell.
+ */
+static inline int64_t cell_coord(float value, double inv_cell) {
+    if (inv_cell == 0.0) {
+        if (value == 0.0f) value = 0.0f;
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return (int64_t)bits;
+    }
+
+    // Clamp far-away (and non-finite) coordinates into range; they only
+    // share a cell, not a weld, since the distance test still applies
+    const double limit = 4.0e18;
+    double c = floor((double)value * inv_cell);
+    if (!(c > -limit)) c = (c < 0.0) ? -limit : 0.0;
+    if (c > limit) c = limit;
+    return (int64_t)c;
+}
+
+static inline WeldCell vertex_cell(const float* p, double inv_cell) {
+    WeldCell cell;
+    cell.x = cell_coord(p[0], inv_cell);
+    cell.y = cell_coord(p[1], inv_cell);
+    cell.z = cell_coord(p[2], inv_cell);
+    return cell;
+}
+
+/**
+ * @brief Hash table of grid cells, each heading a chain of representatives
+ */
+class WeldGrid {
+public:
+    WeldGrid(const float* vertices, int num_vertices, double inv_cell)
+        : vertices_(vertices), inv_cell_(inv_cell), mask_(0) {
+        size_t capacity = 16;
+        while (capacity < (size_t)num_vertices * 2) capacity <<= 1;
+        mask_ = capacity - 1;
+        heads_.assign(capacity, -1);
+        next_.assign(num_vertices, -1);
+    }
+
+    /** First vertex chained in cell, or -1 */
+    int head(const WeldCell& cell) const {
+        size_t slot = hash_cell(cell) & mask_;
+        for (;;) {
+            int v = heads_[slot];
+            if (v < 0) return -1;
+            if (weld_cells_equal(vertex_cell(vertices_ + (size_t)v * 3, inv_cell_), cell)) return v;
+            slot = (slot + 1) & mask_;
+        }
+    }
+
+    int next(int v) const { return next_[v]; }
+
+    /** Add v to its cell's chain (appended, so chains stay in index order) */
+    void insert(int v, const WeldCell& cell) {
+        size_t slot = hash_cell(cell) & mask_;
+        for (;;) {
+            int h = heads_[slot];
+            if (h < 0) {
+                heads_[slot] = v;
+                return;
+            }
+            if (weld_cells_equal(vertex_cell(vertices_ + (size_t)h * 3, inv_cell_), cell)) {
+                while (next_[h] >= 0) h = next_[h];
+                next_[h] = v;
+                return;
+            }
+            slot = (slot + 1) & mask_;
+        }
+    }
+
+private:
+    const float* vertices_;
+    double inv_cell_;
+    size_t mask_;
+    std::vector<int> heads_;
+    std::vector<int> next_;
+};
+
+/**
+ * @brief Map every vertex to its representative
+ * @return Number of representatives
+ */
+static int weld_vertices(const Mesh* mesh, float epsilon, std::vector<int>& rep) {
+    int n = mesh->num_vertices;
+    double inv_cell = epsilon > 0.0f ? 1.0 / (double)epsilon : 0.0;
+    int range = epsilon > 0.0f ? 1 : 0;
+    double eps2 = (double)epsilon * (double)epsilon;
+
+    WeldGrid grid(mesh->vertices, n, inv_cell);
+    rep.assign(n, -1);
+    int num_reps = 0;
+
+    for (int v = 0; v < n; v++) {
+        const float* p = mesh->vertices + (size_t)v * 3;
+        WeldCell cell = vertex_cell(p, inv_cell);
+
+        int best = -1;
+        for (int dz = -range; dz <= range; dz++) {
+            for (int dy = -range; dy <= range; dy++) {
+                for (int dx = -range; dx <= range; dx++) {
+                    WeldCell probe = {cell.x + dx, cell.y + dy, cell.z + dz};
+                    for (int r = grid.head(probe); r >= 0; r = grid.next(r)) {
+                        // Chains are in index order; later entries can't win
+                        if (best >= 0 && r > best) break;
+                        const float* q = mesh->vertices + (size_t)r * 3;
+                        double ex = (double)p[0] - q[0];
+                        double ey = (double)p[1] - q[1];
+                        double ez = (double)p[2] - q[2];
+                        if (ex * ex + ey * ey + ez * ez <= eps2) {
+                            best = r;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (best >= 0) {
+            rep[v] = rep[best];
+        } else {
+            rep[v] = num_reps++;
+            grid.insert(v, cell);
+        }
+    }
+
+    return num_reps;
+}
+
+static inline uint64_t hash_triangle(const int t[3]) {
+    uint64_t h = (uint64_t)(uint32_t)t[0] * 0x9E3779B97F4A7C15ULL;
+    h ^= (h >> 29) ^ ((uint64_t)(uint32_t)t[1] * 0xC2B2AE3D27D4EB4FULL);
+    h ^= (h >> 31) ^ ((uint64_t)(uint32_t)t[2] * 0x165667B19E3779F9ULL);
+    h ^= h >> 32;
+    return h;
+}
+
+static inline void sort3(int t[3]) {
+    int tmp;
+    if (t[0] > t[1]) { tmp = t[0]; t[0] = t[1]; t[1] = tmp; }
+    if (t[1] > t[2]) { tmp = t[1]; t[1] = t[2]; t[2] = tmp; }
+    if (t[0] > t[1]) { tmp = t[0]; t[0] = t[1]; t[1] = tmp; }
+}
+
+static int triangle_has_area(const float* vertices, const int t[3]) {
+    const float* a = vertices + (size_t)t[0] * 3;
+    const float* b = vertices + (size_t)t[1] * 3;
+    const float* c = vertices + (size_t)t[2] * 3;
+    double e1[3] = {(double)b[0] - a[0], (double)b[1] - a[1], (double)b[2] - a[2]};
+    double e2[3] = {(double)c[0] - a[0], (double)c[1] - a[1], (double)c[2] - a[2]};
+    double nx = e1[1] * e2[2] - e1[2] * e2[1];
+    double ny = e1[2] * e2[0] - e1[0] * e2[2];
+    double nz = e1[0] * e2[1] - e1[1] * e2[0];
+    return nx != 0.0 || ny != 0.0 || nz != 0.0;
+}
+
+Mesh* weld_mesh(const Mesh* mesh, float epsilon, WeldStats* stats_out) {
+    if (!mesh || !mesh->vertices || !mesh->triangles || !(epsilon >= 0.0f)) {
+        fprintf(stderr, "weld_mesh: Invalid arguments\n");
+        return NULL;
+    }
+
+    std::vector<int> rep;
+    int num_reps = weld_vertices(mesh, epsilon, rep);
+
+    Mesh* result = (Mesh*)malloc(sizeof(Mesh));
+    result->num_vertices = num_reps;
+    result->vertices = (float*)malloc((size_t)num_reps * 3 * sizeof(float));
+    result->uvs = mesh->uvs ? (float*)malloc((size_t)num_reps * 2 * sizeof(float)) : NULL;
+
+    // Representatives are numbered in index order, so the first vertex seen
+    // for each new index is the representative itself
+    int written = 0;
+    for (int v = 0; v < mesh->num_vertices && written < num_reps; v++) {
+        if (rep[v] != written) continue;
+        memcpy(result->vertices + (size_t)written * 3, mesh->vertices + (size_t)v * 3, 3 * sizeof(float));
+        if (result->uvs) {
+            memcpy(result->uvs + (size_t)written * 2, mesh->uvs + (size_t)v * 2, 2 * sizeof(float));
+        }
+        written++;
+    }
+
+    // Remap triangles, dropping degenerate ones and repeats of earlier ones
+    size_t capacity = 16;
+    while (capacity < (size_t)mesh->num_triangles * 2) capacity <<= 1;
+    std::vector<int> table(capacity, -1);
+    std::vector<int> sorted_tris;
+    sorted_tris.reserve((size_t)mesh->num_triangles * 3);
+
+    result->triangles = (int*)malloc((size_t)mesh->num_triangles * 3 * sizeof(int));
+    int num_tris = 0;
+    int degenerate = 0;
+    int duplicate = 0;
+
+    for (int f = 0; f < mesh->num_triangles; f++) {
+        const int* src = mesh->triangles + (size_t)f * 3;
+        int t[3] = {rep[src[0]], rep[src[1]], rep[src[2]]};
+
+        if (t[0] == t[1] || t[1] == t[2] || t[0] == t[2] ||
+            !triangle_has_area(result->vertices, t)) {
+            degenerate++;
+            continue;
+        }
+
+        int key[3] = {t[0], t[1], t[2]};
+        sort3(key);
+
+        size_t slot = hash_triangle(key) & (capacity - 1);
+        int found = 0;
+        for (;;) {
+            int k = table[slot];
+            if (k < 0) break;
+            if (memcmp(&sorted_tris[(size_t)k * 3], key, sizeof(key)) == 0) {
+                found = 1;
+                break;
+            }
+            slot = (slot + 1) & (capacity - 1);
+        }
+        if (found) {
+            duplicate++;
+            continue;
+        }
+
+        table[slot] = num_tris;
+        sorted_tris.insert(sorted_tris.end(), key, key + 3);
+        memcpy(result->triangles + (size_t)num_tris * 3, t, sizeof(t));
+        num_tris++;
+    }
+
+    result->num_triangles = num_tris;
+    if (num_tris > 0) {
+        result->triangles = (int*)realloc(result->triangles, (size_t)num_tris * 3 * sizeof(int));
+    }
+
+    if (stats_out) {
+        stats_out->merged_vertices = mesh->num_vertices - num_reps;
+        stats_out->degenerate_triangles = degenerate;
+        stats_out->duplicate_triangles = duplicate;
+    }
+
+    return result;
+}
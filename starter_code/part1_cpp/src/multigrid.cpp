@@ -0,0 +1,455 @@
+/**
+ * @file multigrid.cpp
+ * @brief Aggregation multigrid for the LSCM system
+ *
+ * Levels are built by clustering rather than by remeshing: each aggregate
+ * of fine vertices becomes one coarse node, so no geometry is needed and
+ * every island, however irregular, coarsens the same way.
+ */
+
+// GCC reports -Wmaybe-uninitialized inside Eigen's blocked Householder
+// code (TriangularMatrixVector.h), which HouseholderQR instantiates
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include "multigrid.h"
+#include <Eigen/LU>
+#include <Eigen/QR>
+#include <Eigen/SparseCholesky>
+#include <Eigen/OrderingMethods>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+typedef Eigen::SparseMatrix<double> SpMat;
+
+// Stop coarsening at this many unknowns and factorize directly
+#define MG_COARSE_UNKNOWNS 1000
+#define MG_MAX_LEVELS 25
+// A coarse level must shrink the unknown count at least this much
+#define MG_MIN_COARSENING 0.8
+// Blocks i, j are strongly connected if |A_ij|^2 > theta^2 |A_ii| |A_jj|
+#define MG_STRENGTH_THETA 0.08
+#define MG_POWER_ITERATIONS 15
+// Coarse-grid corrections per level: 1 = V-cycle, 2 = W-cycle
+#define MG_CYCLE_INDEX 2
+
+/**
+ * @brief One level of the hierarchy
+ *
+ * P interpolates from the next coarser level to this one. Level 0 borrows
+ * the caller's matrix instead of copying it.
+ */
+struct MultigridLevel {
+    const SpMat* A;
+    SpMat coarse_A;             // Storage for A below level 0
+    SpMat P;
+    int block_size;
+};
+
+/**
+ * @brief Estimate the spectral radius of D^-1 A by power iteration
+ */
+static double jacobi_spectral_radius(const SpMat& A, const SpMat& inv_diag) {
+    Eigen::VectorXd x(A.rows());
+    for (Eigen::Index i = 0; i < x.size(); i++) {
+        x[i] = 1.0 + 0.5 * sin(0.37 * (double)i);   // Deterministic, not an eigenvector
+    }
+    double rho = 1.0;
+    for (int it = 0; it < MG_POWER_ITERATIONS; it++) {
+        Eigen::VectorXd y = inv_diag * (A * x);
+        double norm = y.norm();
+        if (norm == 0.0) break;
+        rho = norm / x.norm();
+        x = y / norm;
+    }
+    // Power iteration approaches rho from below; stay on the safe side
+    return 1.1 * rho;
+}
+
+/**
+ * @brief Inverse of the block_size x block_size block diagonal of A
+ *
+ * Coarse blocks mix unknowns of very different scale (an aggregate's
+ * translation and its rotation), which a scalar diagonal cannot balance
+ * when smoothing the interpolation. Every column holds exactly its block's
+ * block_size rows, so the result is written in compressed form directly.
+ */
+static SpMat block_diagonal_inverse(const SpMat& A, int block_size) {
+    Eigen::Index n = A.rows();
+    SpMat inv_diag(n, n);
+    inv_diag.resizeNonZeros(n * block_size);
+    int* col_starts = inv_diag.outerIndexPtr();
+    int* rows = inv_diag.innerIndexPtr();
+    double* values = inv_diag.valuePtr();
+
+    Eigen::MatrixXd block(block_size, block_size);
+    for (Eigen::Index start = 0; start < n; start += block_size) {
+        block.setZero();
+        for (int c = 0; c < block_size; c++) {
+            for (SpMat::InnerIterator it(A, start + c); it; ++it) {
+                Eigen::Index r = it.row() - start;
+                if (r >= 0 && r < block_size) block(r, c) = it.value();
+            }
+        }
+        Eigen::MatrixXd inverse = block.inverse();
+        for (int c = 0; c < block_size; c++) {
+            int column = (int)(start + c);
+            col_starts[column] = column * block_size;
+            for (int r = 0; r < block_size; r++) {
+                rows[column * block_size + r] = (int)(start + r);
+                values[column * block_size + r] = inverse(r, c);
+            }
+        }
+    }
+    col_starts[n] = (int)(n * block_size);
+    return inv_diag;
+}
+
+/**
+ * @brief Frobenius norms of the block_size x block_size blocks of A
+ *
+ * Returns block adjacency in CSR form (diagonal excluded) with the norm of
+ * each off-diagonal block, and the diagonal block norms separately.
+ */
+static void block_graph(const SpMat& A, int block_size,
+                        std::vector<int>* offsets, std::vector<int>* neighbors,
+                        std::vector<double>* weights, std::vector<double>* diag) {
+    int nb = (int)A.cols() / block_size;
+    offsets->assign(nb + 1, 0);
+    neighbors->clear();
+    weights->clear();
+    diag->assign(nb, 0.0);
+
+    std::vector<double> accum(nb, 0.0);
+    std::vector<int> touched;
+    for (int j = 0; j < nb; j++) {
+        for (int c = 0; c < block_size; c++) {
+            for (SpMat::InnerIterator it(A, j * block_size + c); it; ++it) {
+                int i = (int)it.row() / block_size;
+                if (accum[i] == 0.0) touched.push_back(i);
+                accum[i] += it.value() * it.value();
+            }
+        }
+        for (int i : touched) {
+            if (i == j) {
+                (*diag)[j] = sqrt(accum[i]);
+            } else if (accum[i] > 0.0) {
+                neighbors->push_back(i);
+                weights->push_back(sqrt(accum[i]));
+            }
+            accum[i] = 0.0;
+        }
+        touched.clear();
+        (*offsets)[j + 1] = (int)neighbors->size();
+    }
+}
+
+/**
+ * @brief Greedy aggregation of blocks over strong connections
+ *
+ * Pass 1 seeds an aggregate at every block whose strong neighbours are all
+ * still free and takes them along; pass 2 attaches the leftovers to an
+ * adjacent aggregate; pass 3 makes singletons of anything still isolated.
+ *
+ * @return Number of aggregates
+ */
+static int aggregate_blocks(const SpMat& A, int block_size, std::vector<int>* agg) {
+    std::vector<int> offsets, neighbors;
+    std::vector<double> weights, diag;
+    block_graph(A, block_size, &offsets, &neighbors, &weights, &diag);
+
+    int nb = (int)offsets.size() - 1;
+    std::vector<char> strong(neighbors.size(), 0);
+    for (int i = 0; i < nb; i++) {
+        for (int k = offsets[i]; k < offsets[i + 1]; k++) {
+            double w = weights[k];
+            strong[k] = w * w > MG_STRENGTH_THETA * MG_STRENGTH_THETA * diag[i] * diag[neighbors[k]];
+        }
+    }
+
+    agg->assign(nb, -1);
+    int num_aggs = 0;
+    for (int i = 0; i < nb; i++) {
+        if ((*agg)[i] >= 0) continue;
+        bool free_neighborhood = true;
+        for (int k = offsets[i]; k < offsets[i + 1] && free_neighborhood; k++) {
+            if (strong[k] && (*agg)[neighbors[k]] >= 0) free_neighborhood = false;
+        }
+        if (!free_neighborhood) continue;
+        (*agg)[i] = num_aggs;
+        for (int k = offsets[i]; k < offsets[i + 1]; k++) {
+            if (strong[k]) (*agg)[neighbors[k]] = num_aggs;
+        }
+        num_aggs++;
+    }
+
+    // Pass 2 reads only pass-1 assignments so the result is order-stable
+    std::vector<int> seeded = *agg;
+    for (int i = 0; i < nb; i++) {
+        if ((*agg)[i] >= 0) continue;
+        double best = 0.0;
+        for (int k = offsets[i]; k < offsets[i + 1]; k++) {
+            if (strong[k] && seeded[neighbors[k]] >= 0 && weights[k] > best) {
+                best = weights[k];
+                (*agg)[i] = seeded[neighbors[k]];
+            }
+        }
+    }
+
+    for (int i = 0; i < nb; i++) {
+        if ((*agg)[i] < 0) (*agg)[i] = num_aggs++;
+    }
+    return num_aggs;
+}
+
+/**
+ * @brief Smoothed-aggregation interpolation P = (I - omega D^-1 A) P_tent
+ *
+ * D is the block diagonal of A and omega = 4 / (3 rho(D^-1 A)).
+ *
+ * P_tent restricted to one aggregate is the Q factor of the near-nullspace
+ * rows of its blocks, so every near-nullspace vector is interpolated
+ * exactly; the R factors become the near-nullspace of the coarse level,
+ * whose blocks have one unknown per near-nullspace vector.
+ */
+static SpMat build_interpolation(const SpMat& A, int block_size,
+                                 const Eigen::MatrixXd& near_null,
+                                 const std::vector<int>& agg, int num_aggs,
+                                 Eigen::MatrixXd* coarse_near_null) {
+    Eigen::Index n = A.rows();
+    int k = (int)near_null.cols();
+
+    // Blocks grouped by aggregate (counting sort keeps them in order)
+    std::vector<int> agg_offsets(num_aggs + 1, 0);
+    for (int a : agg) agg_offsets[a + 1]++;
+    for (int a = 0; a < num_aggs; a++) agg_offsets[a + 1] += agg_offsets[a];
+    std::vector<int> members(agg.size());
+    std::vector<int> fill(agg_offsets.begin(), agg_offsets.end() - 1);
+    for (int i = 0; i < (int)agg.size(); i++) members[fill[agg[i]]++] = i;
+
+    // Aggregate a owns columns a * k .. a * k + k - 1 and its members' rows
+    // in increasing order, so P_tent is written in compressed form directly
+    SpMat tentative(n, (Eigen::Index)num_aggs * k);
+    int* col_starts = tentative.outerIndexPtr();
+    size_t nnz = 0;
+    for (int a = 0; a < num_aggs; a++) {
+        size_t rows = (size_t)(agg_offsets[a + 1] - agg_offsets[a]) * block_size;
+        nnz += rows * std::min(rows, (size_t)k);
+    }
+    tentative.resizeNonZeros((Eigen::Index)nnz);
+    int* tentative_rows = tentative.innerIndexPtr();
+    double* tentative_values = tentative.valuePtr();
+
+    int out = 0;
+    coarse_near_null->setZero((Eigen::Index)num_aggs * k, k);
+    for (int a = 0; a < num_aggs; a++) {
+        int num_members = agg_offsets[a + 1] - agg_offsets[a];
+        int rows = num_members * block_size;
+        Eigen::MatrixXd local(rows, k);
+        for (int m = 0; m < num_members; m++) {
+            int i = members[agg_offsets[a] + m];
+            local.middleRows(m * block_size, block_size) = near_null.middleRows(i * block_size, block_size);
+        }
+
+        // An aggregate with fewer unknowns than near-nullspace vectors gets
+        // zero columns; the matching coarse unknowns are decoupled later
+        int cols = std::min(rows, k);
+        Eigen::HouseholderQR<Eigen::MatrixXd> qr(local);
+        Eigen::MatrixXd Q = qr.householderQ() * Eigen::MatrixXd::Identity(rows, cols);
+        coarse_near_null->block((Eigen::Index)a * k, 0, cols, k) =
+            qr.matrixQR().topRows(cols).triangularView<Eigen::Upper>();
+
+        for (int q = 0; q < k; q++) {
+            col_starts[a * k + q] = out;
+            if (q >= cols) continue;
+            for (int m = 0; m < num_members; m++) {
+                int i = members[agg_offsets[a] + m];
+                for (int c = 0; c < block_size; c++) {
+                    tentative_rows[out] = i * block_size + c;
+                    tentative_values[out] = Q(m * block_size + c, q);
+                    out++;
+                }
+            }
+        }
+    }
+    col_starts[(size_t)num_aggs * k] = out;
+
+    // Each temporary is dropped as soon as the next one exists; on large
+    // islands every one of them is about as big as A
+    SpMat inv_diag = block_diagonal_inverse(A, block_size);
+    double omega = 4.0 / (3.0 * jacobi_spectral_radius(A, inv_diag));
+    SpMat smoothed;
+    {
+        SpMat AP = A * tentative;
+        smoothed = inv_diag * AP;
+    }
+    inv_diag = SpMat();
+    SpMat P = tentative - omega * smoothed;
+    P.prune(0.0);
+    return P;
+}
+
+/**
+ * @brief Gauss-Seidel sweep on A x = b, forward or backward
+ *
+ * A is symmetric, so column i doubles as row i.
+ */
+static void gauss_seidel(const SpMat& A, const Eigen::VectorXd& b, bool forward,
+                         Eigen::VectorXd* x) {
+    Eigen::Index n = A.cols();
+    for (Eigen::Index s = 0; s < n; s++) {
+        Eigen::Index i = forward ? s : n - 1 - s;
+        double sum = b[i], diag = 0.0;
+        for (SpMat::InnerIterator it(A, i); it; ++it) {
+            if (it.row() == i) diag = it.value();
+            else sum -= it.value() * (*x)[it.row()];
+        }
+        (*x)[i] = sum / diag;
+    }
+}
+
+/**
+ * @brief Multigrid hierarchy with a direct solver at the bottom
+ */
+struct MultigridHierarchy {
+    std::vector<MultigridLevel> levels;
+    Eigen::SimplicialLDLT<SpMat, Eigen::Lower, Eigen::AMDOrdering<int> > coarse;
+
+    /**
+     * @brief One cycle approximating A^-1 b on level l, starting from zero
+     *
+     * A forward Gauss-Seidel sweep before the coarse-grid corrections and a
+     * backward one after make the cycle a symmetric operator, so it can
+     * precondition CG.
+     */
+    void cycle(size_t l, const Eigen::VectorXd& b, Eigen::VectorXd* x) const {
+        if (l + 1 == levels.size()) {
+            *x = coarse.solve(b);
+            return;
+        }
+        const MultigridLevel& level = levels[l];
+        x->setZero(b.size());
+        gauss_seidel(*level.A, b, true, x);
+        // The level above the direct solve gains nothing from a second pass
+        int corrections = l + 2 < levels.size() ? MG_CYCLE_INDEX : 1;
+        for (int c = 0; c < corrections; c++) {
+            Eigen::VectorXd coarse_rhs = level.P.transpose() * (b - *level.A * *x);
+            Eigen::VectorXd coarse_x;
+            cycle(l + 1, coarse_rhs, &coarse_x);
+            *x += level.P * coarse_x;
+        }
+        gauss_seidel(*level.A, b, false, x);
+    }
+};
+
+/**
+ * @brief Build levels until the system is small enough to factorize
+ * @return 1 on success, 0 if the coarsest factorization failed
+ */
+static int build_hierarchy(const SpMat& A, const Eigen::MatrixXd& near_null,
+                           int block_size, MultigridHierarchy* mg) {
+    // Levels point into each other's storage; never reallocate
+    mg->levels.clear();
+    mg->levels.reserve(MG_MAX_LEVELS);
+    mg->levels.push_back(MultigridLevel());
+    mg->levels.back().A = &A;
+    mg->levels.back().block_size = block_size;
+    Eigen::MatrixXd B = near_null;
+
+    while ((int)mg->levels.size() < MG_MAX_LEVELS) {
+        MultigridLevel& level = mg->levels.back();
+        Eigen::Index n = level.A->rows();
+        if (n <= MG_COARSE_UNKNOWNS) break;
+
+        std::vector<int> agg;
+        int num_aggs = aggregate_blocks(*level.A, level.block_size, &agg);
+        if ((double)num_aggs * B.cols() > MG_MIN_COARSENING * n) break;
+
+        Eigen::MatrixXd coarse_B;
+        level.P = build_interpolation(*level.A, level.block_size, B, agg, num_aggs, &coarse_B);
+        SpMat AP = *level.A * level.P;
+        SpMat coarse_A = SpMat(level.P.transpose()) * AP;
+        AP = SpMat();
+
+        // Unknowns without interpolation (zero columns of P) are decoupled
+        // but must not leave a zero on the diagonal
+        for (Eigen::Index j = 0; j < coarse_A.cols(); j++) {
+            if (coarse_A.coeff(j, j) == 0.0) coarse_A.coeffRef(j, j) = 1.0;
+        }
+
+        B.swap(coarse_B);
+        mg->levels.push_back(MultigridLevel());
+        MultigridLevel& next = mg->levels.back();
+        next.coarse_A.swap(coarse_A);
+        next.A = &next.coarse_A;
+        next.block_size = (int)B.cols();
+    }
+
+    mg->coarse.compute(*mg->levels.back().A);
+    return mg->coarse.info() == Eigen::Success;
+}
+
+int multigrid_solve(const Eigen::SparseMatrix<double>& A,
+                    const Eigen::VectorXd& b,
+                    const Eigen::MatrixXd& near_null,
+                    int block_size,
+                    double tolerance,
+                    int max_iterations,
+                    int verbose,
+                    Eigen::VectorXd* x,
+                    int* iterations_out,
+                    double* residual_out) {
+    MultigridHierarchy mg;
+    if (!build_hierarchy(A, near_null, block_size, &mg)) return 0;
+    if (verbose) {
+        printf("  Multigrid: %d levels, %d coarsest unknowns\n",
+               (int)mg.levels.size(), (int)mg.levels.back().A->rows());
+    }
+
+    if (max_iterations <= 0) max_iterations = 2 * (int)A.rows();
+    double b_norm = b.norm();
+    if (b_norm == 0.0) {
+        x->setZero(A.rows());
+        *iterations_out = 0;
+        *residual_out = 0.0;
+        return 1;
+    }
+
+    // Preconditioned conjugate gradient with one cycle per iteration
+    Eigen::VectorXd r = b - A * *x;
+    double residual = r.norm() / b_norm;
+    Eigen::VectorXd z, p, Ap;
+    double rz = 0.0;
+    int it = 0;
+    while (residual > tolerance && it < max_iterations) {
+        mg.cycle(0, r, &z);
+        double rz_new = r.dot(z);
+        if (it == 0) {
+            p = z;
+        } else {
+            p = z + (rz_new / rz) * p;
+        }
+        rz = rz_new;
+
+        Ap = A * p;
+        double alpha = rz / p.dot(Ap);
+        *x += alpha * p;
+        r -= alpha * Ap;
+        residual = r.norm() / b_norm;
+        it++;
+    }
+
+    *iterations_out = it;
+    *residual_out = residual;
+    if (residual > tolerance && verbose) {
+        printf("  Multigrid CG stopped after %d iterations (residual %.2e)\n", it, residual);
+    }
+    return 1;
+}
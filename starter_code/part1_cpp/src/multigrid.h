@@ -0,0 +1,54 @@
+/**
+ * @file multigrid.h
+ * @brief Aggregation multigrid for the LSCM system
+ *
+ * INTERNAL - not installed with the public headers
+ */
+
+#ifndef MULTIGRID_H
+#define MULTIGRID_H
+
+#include <Eigen/Sparse>
+
+/**
+ * @brief Solve A x = b with multigrid-preconditioned conjugate gradient
+ *
+ * A must be symmetric positive definite with its unknowns grouped in
+ * blocks of block_size (u and v of one vertex). Coarse levels come from
+ * clustering: blocks are aggregated with their strongly connected
+ * neighbours, and each aggregate interpolates the near-nullspace - the
+ * vectors A barely changes, such as translations and similarities of the
+ * map - exactly. That interpolation is smoothed once by damped Jacobi and
+ * the coarse operator is P^T A P. The hierarchy stops at about a thousand
+ * unknowns, which are factorized directly. One W-cycle with symmetric
+ * Gauss-Seidel smoothing preconditions each CG iteration.
+ *
+ * Each level has a constant factor fewer unknowns than the one above, but
+ * the smoothed interpolation makes coarse operators denser than A, so the
+ * total is not small: on large LSCM islands it stays below, but close to,
+ * the memory of a SimplicialLDLT factor.
+ *
+ * @param A System matrix (both triangles stored)
+ * @param b Right-hand side
+ * @param near_null Near-nullspace vectors, one per column
+ * @param block_size Unknowns per block
+ * @param tolerance Relative residual |b - Ax| / |b| to stop at
+ * @param max_iterations Iteration cap (0 = twice the unknowns)
+ * @param verbose Print the hierarchy and non-convergence to stdout
+ * @param x In: initial guess, out: solution
+ * @param iterations_out Output: CG iterations
+ * @param residual_out Output: final relative residual
+ * @return 1 on success (converged or out of iterations), 0 on failure
+ */
+int multigrid_solve(const Eigen::SparseMatrix<double>& A,
+                    const Eigen::VectorXd& b,
+                    const Eigen::MatrixXd& near_null,
+                    int block_size,
+                    double tolerance,
+                    int max_iterations,
+                    int verbose,
+                    Eigen::VectorXd* x,
+                    int* iterations_out,
+                    double* residual_out);
+
+#endif /* MULTIGRID_H */
@@ -0,0 +1,71 @@
+/**
+ * @file parallel.h
+ * @brief Minimal fork-join helpers built on std::thread
+ *
+ * INTERNAL - not installed with the public headers
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdlib.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Resolve a requested worker count
+ *
+ * @param requested Explicit count, or <= 0 for automatic
+ * @return requested if positive, else $UVUNWRAP_NUM_THREADS if set,
+ *         else the number of hardware threads (at least 1)
+ */
+static inline int resolve_num_threads(int requested) {
+    if (requested > 0) return requested;
+
+    const char* env = getenv("UVUNWRAP_NUM_THREADS");
+    if (env) {
+        int n = atoi(env);
+        if (n > 0) return n;
+    }
+
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? (int)hw : 1;
+}
+
+/**
+ * @brief Run fn(task) for task in [0, num_tasks) on up to num_threads threads
+ *
+ * Tasks are handed out dynamically from a shared counter, so uneven task
+ * sizes balance themselves. The calling thread takes part in the work.
+ * With one thread (or one task) everything runs inline, in order.
+ */
+template <typename Fn>
+static void parallel_for(int num_tasks, int num_threads, Fn fn) {
+    if (num_tasks <= 0) return;
+
+    if (num_threads > num_tasks) num_threads = num_tasks;
+    if (num_threads <= 1) {
+        for (int i = 0; i < num_tasks; i++) fn(i);
+        return;
+    }
+
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        for (;;) {
+            int i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= num_tasks) break;
+            fn(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (int t = 1; t < num_threads; t++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& t : threads) t.join();
+}
+
+#endif /* PARALLEL_H */
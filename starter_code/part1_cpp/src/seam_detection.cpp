@@ -2,117 +2,490 @@
  * @file seam_detection.cpp
  * @brief Seam detection using spanning tree + angular defect
  *
- * SKELETON - YOU IMPLEMENT THIS
- *
- * Algorithm:
+ * Algorithm (SEAM_MODE_SPANNING_TREE):
  * 1. Build dual graph (faces as nodes, shared edges as edges)
- * 2. Compute spanning tree via BFS
+ * 2. Compute spanning forest via level-synchronous (parallel) BFS
  * 3. Mark non-tree edges as seam candidates
  * 4. Refine using angular defect
  *
+ * SEAM_MODE_CURVATURE_MST replaces 2-4 with a Kruskal maximum spanning
+ * tree weighted by edge length and flatness, and prunes the resulting cut
+ * back to the cones and the boundary.
+ *
+ * SEAM_MODE_SHORTEST_PATH keeps only the loops of that cut and links the
+ * cones to it and to the boundary along shortest paths (Steiner tree).
+ *
+ * All adjacency (dual graph neighbours, faces and edges around a vertex)
+ * comes from the CSR tables in TopologyInfo, so every query is O(degree).
+ *
  * See reference/algorithms.md for detailed description
  */
 
 #include "unwrap.h"
 #include "math_utils.h"
+#include "bitset.h"
+#include "parallel.h"
+#include "union_find.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
-#include <vector>
-#include <set>
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <queue>
+#include <utility>
+#include <vector>
+
+// Frontiers smaller than this are expanded on the calling thread
+#define BFS_PARALLEL_MIN_FRONTIER 1024
+
+// Vertex marks for prune_cut()
+#define ANCHOR_CONE 1
+#define ANCHOR_BOUNDARY 2
+
+/**
+ * @brief Unit normal of a triangle
+ */
+static Vec3 face_normal(const Mesh* mesh, int face_idx) {
+    const int* tri = mesh->triangles + face_idx * 3;
+    Vec3 p0 = get_vertex_position(mesh, tri[0]);
+    Vec3 p1 = get_vertex_position(mesh, tri[1]);
+    Vec3 p2 = get_vertex_position(mesh, tri[2]);
+    return vec3_normalize(vec3_cross(vec3_sub(p1, p0), vec3_sub(p2, p0)));
+}
 
 /**
- * @brief Compute angular defect at a vertex
+ * @brief Length of edge e
+ */
+static inline float edge_length(const Mesh* mesh, const TopologyInfo* topo, int e) {
+    Vec3 a = get_vertex_position(mesh, topo->edges[e * 2]);
+    Vec3 b = get_vertex_position(mesh, topo->edges[e * 2 + 1]);
+    return vec3_length(vec3_sub(b, a));
+}
+
+/**
+ * @brief Face across side k of face f, or -1 on a boundary
+ */
+static inline int dual_neighbor(const TopologyInfo* topo, int f, int k) {
+    int e = topo->face_edges[f * 3 + k];
+    int g = topo->edge_faces[e * 2];
+    return g == f ? topo->edge_faces[e * 2 + 1] : g;
+}
+
+/**
+ * @brief Spanning forest of the dual graph by level-synchronous BFS
  *
- * Angular defect = 2π - sum of angles at vertex
+ * Components are rooted at their lowest face. Each level's frontier is
+ * expanded in parallel: a face is claimed by whichever thread reaches it
+ * first, but its tree edge always goes to its lowest-index neighbour on
+ * the previous level, so the forest is the same for any thread count.
  *
- * - Flat surface: defect ≈ 0
- * - Corner (like cube): defect > 0
- * - Saddle: defect < 0
+ * @param topo Topology (face_edges / edge_faces form the dual graph)
+ * @param num_faces Number of faces
+ * @param num_threads Workers
+ * @param tree_out Output: bit per edge, set for dual tree edges
+ */
+static void build_dual_spanning_forest(const TopologyInfo* topo, int num_faces,
+                                       int num_threads, BitSet* tree_out) {
+    std::vector<std::atomic<int> > level(num_faces);
+    for (int f = 0; f < num_faces; f++) level[f].store(-1, std::memory_order_relaxed);
+    std::vector<int> parent_edge(num_faces, -1);
+
+    // Claim the unvisited neighbours of frontier[begin, end) for level l + 1
+    auto expand = [&](const std::vector<int>& frontier, size_t begin, size_t end, int l,
+                      std::vector<int>& next) {
+        for (size_t i = begin; i < end; i++) {
+            int f = frontier[i];
+            for (int k = 0; k < 3; k++) {
+                int g = dual_neighbor(topo, f, k);
+                if (g < 0) continue;
+                int expected = -1;
+                if (!level[g].compare_exchange_strong(expected, l + 1, std::memory_order_relaxed)) continue;
+
+                int best_face = -1;
+                int best_edge = -1;
+                for (int j = 0; j < 3; j++) {
+                    int h = dual_neighbor(topo, g, j);
+                    if (h < 0 || level[h].load(std::memory_order_relaxed) != l) continue;
+                    int e = topo->face_edges[g * 3 + j];
+                    if (best_face < 0 || h < best_face || (h == best_face && e < best_edge)) {
+                        best_face = h;
+                        best_edge = e;
+                    }
+                }
+                parent_edge[g] = best_edge;
+                next.push_back(g);
+            }
+        }
+    };
+
+    std::vector<int> frontier;
+    std::vector<int> next;
+    int num_chunks = num_threads * 4;
+    std::vector<std::vector<int> > chunk_next(num_chunks);
+
+    for (int root = 0; root < num_faces; root++) {
+        if (level[root].load(std::memory_order_relaxed) >= 0) continue;
+        level[root].store(0, std::memory_order_relaxed);
+        frontier.assign(1, root);
+
+        for (int l = 0; !frontier.empty(); l++) {
+            next.clear();
+            if (num_threads <= 1 || frontier.size() < BFS_PARALLEL_MIN_FRONTIER) {
+                expand(frontier, 0, frontier.size(), l, next);
+            } else {
+                parallel_for(num_chunks, num_threads, [&](int c) {
+                    chunk_next[c].clear();
+                    expand(frontier, frontier.size() * c / num_chunks,
+                           frontier.size() * (c + 1) / num_chunks, l, chunk_next[c]);
+                });
+                for (const std::vector<int>& part : chunk_next) {
+                    next.insert(next.end(), part.begin(), part.end());
+                }
+            }
+            frontier.swap(next);
+        }
+    }
+
+    tree_out->resize(topo->num_edges);
+    for (int f = 0; f < num_faces; f++) {
+        if (parent_edge[f] >= 0) tree_out->set(parent_edge[f]);
+    }
+}
+
+/**
+ * @brief Cut of the BFS dual forest, refined at uncut cones
+ */
+static void spanning_tree_seams(const Mesh* mesh, const TopologyInfo* topo,
+                                const std::vector<float>& defects, float defect_threshold,
+                                int num_threads, BitSet* is_seam) {
+    int num_edges = topo->num_edges;
+
+    // STEP 1-2: Spanning forest of the dual graph (one tree per component)
+    BitSet tree_edge;
+    build_dual_spanning_forest(topo, mesh->num_triangles, num_threads, &tree_edge);
+
+    // STEP 3: Initial seam candidates = interior non-tree edges
+    for (int e = 0; e < num_edges; e++) {
+        if (topo->edge_faces[e * 2 + 1] >= 0 && !tree_edge.test(e)) is_seam->set(e);
+    }
+
+    // STEP 4: Angular defect refinement. A vertex whose defect exceeds the
+    // threshold can only flatten if a seam reaches it; if none does yet,
+    // cut its sharpest interior edge. Cutting every incident edge instead
+    // would cut a cube into its 12 triangles. The faces around a manifold
+    // interior vertex form a cycle the tree cannot contain, so this only
+    // adds edges at non-manifold vertices.
+    for (int v = 0; v < mesh->num_vertices; v++) {
+        if (topo->vertex_face_offsets[v] == topo->vertex_face_offsets[v + 1]) continue;
+        if (defects[v] <= defect_threshold) continue;
+
+        int sharpest = -1;
+        float sharpest_cos = 2.0f;
+        int has_seam = 0;
+        for (int i = topo->vertex_edge_offsets[v]; i < topo->vertex_edge_offsets[v + 1]; i++) {
+            int e = topo->vertex_edges[i];
+            if (is_seam->test(e) || topo->edge_faces[e * 2 + 1] < 0) {
+                has_seam = 1;   // Boundaries relieve curvature too
+                break;
+            }
+            float c = vec3_dot(face_normal(mesh, topo->edge_faces[e * 2]),
+                               face_normal(mesh, topo->edge_faces[e * 2 + 1]));
+            if (c < sharpest_cos) {
+                sharpest_cos = c;
+                sharpest = e;
+            }
+        }
+        if (!has_seam && sharpest >= 0) is_seam->set(sharpest);
+    }
+}
+
+/**
+ * @brief Remove dangling cut edges that do not end at an anchor
  *
- * @param mesh Input mesh
- * @param vertex_idx Vertex index
- * @return Angular defect in radians
+ * Repeatedly drops a cut edge whose endpoint v has cut degree 1 and is not
+ * an anchor. The last edge left at a cone, or anywhere on a mesh component
+ * without boundary, is kept, so neither a lone cone nor a closed surface is
+ * left uncut.
+ */
+static void prune_cut(const TopologyInfo* topo, const std::vector<char>& anchor, BitSet* is_seam) {
+    int num_vertices = topo->num_vertices;
+
+    // Mesh components (over vertices) that have a boundary
+    UnionFind components(num_vertices);
+    for (int e = 0; e < topo->num_edges; e++) {
+        components.unite(topo->edges[e * 2], topo->edges[e * 2 + 1]);
+    }
+    std::vector<char> open(num_vertices, 0);
+    for (int v = 0; v < num_vertices; v++) {
+        if (anchor[v] == ANCHOR_BOUNDARY) open[components.find(v)] = 1;
+    }
+
+    std::vector<int> degree(num_vertices, 0);
+    for (int e = 0; e < topo->num_edges; e++) {
+        if (!is_seam->test(e)) continue;
+        degree[topo->edges[e * 2]]++;
+        degree[topo->edges[e * 2 + 1]]++;
+    }
+
+    std::vector<int> leaves;
+    for (int v = 0; v < num_vertices; v++) {
+        if (degree[v] == 1 && !anchor[v]) leaves.push_back(v);
+    }
+
+    while (!leaves.empty()) {
+        int v = leaves.back();
+        leaves.pop_back();
+        if (degree[v] != 1) continue;
+
+        int cut = -1;
+        for (int i = topo->vertex_edge_offsets[v]; i < topo->vertex_edge_offsets[v + 1]; i++) {
+            if (is_seam->test(topo->vertex_edges[i])) {
+                cut = topo->vertex_edges[i];
+                break;
+            }
+        }
+        int u = topo->edges[cut * 2] == v ? topo->edges[cut * 2 + 1] : topo->edges[cut * 2];
+        if (degree[u] == 1 && (anchor[u] == ANCHOR_CONE || !open[components.find(u)])) {
+            continue;   // Last edge of this cut component
+        }
+
+        is_seam->reset(cut);
+        degree[v] = 0;
+        if (--degree[u] == 1 && !anchor[u]) leaves.push_back(u);
+    }
+}
+
+/**
+ * @brief Interior edges left out of a curvature-weighted maximum spanning tree
  */
-static float compute_angular_defect(const Mesh* mesh, int vertex_idx) {
-    // TODO: Implement
-    //
-    // Steps:
-    // 1. Find all triangles containing this vertex
-    // 2. For each triangle, compute angle at this vertex
-    //    (use compute_vertex_angle_in_triangle from math_utils.h)
-    // 3. Sum all angles
-    // 4. Return 2*PI - sum
-    //
-    // Hint: Angular defect indicates curvature
-    //       High defect → sharp feature → good seam location
-
-    float angle_sum = 0.0f;
-
-    // YOUR CODE HERE
-
-    return 2.0f * M_PI - angle_sum;
+static void curvature_mst_cut(const Mesh* mesh, const TopologyInfo* topo, BitSet* is_seam) {
+    int num_edges = topo->num_edges;
+
+    // Weight = length * (pi - bend): joining long, flat edges is worth most
+    std::vector<int> interior;
+    std::vector<float> weight(num_edges, 0.0f);
+    for (int e = 0; e < num_edges; e++) {
+        if (topo->edge_faces[e * 2 + 1] < 0) continue;
+        float c = vec3_dot(face_normal(mesh, topo->edge_faces[e * 2]),
+                           face_normal(mesh, topo->edge_faces[e * 2 + 1]));
+        float bend = acosf(fmaxf(-1.0f, fminf(1.0f, c)));
+        weight[e] = edge_length(mesh, topo, e) * ((float)M_PI - bend);
+        interior.push_back(e);
+    }
+
+    // Kruskal, heaviest first; ties by edge index keep the result stable
+    std::sort(interior.begin(), interior.end(), [&](int x, int y) {
+        return weight[x] > weight[y] || (weight[x] == weight[y] && x < y);
+    });
+
+    UnionFind faces(mesh->num_triangles);
+    for (int e : interior) {
+        if (!faces.unite(topo->edge_faces[e * 2], topo->edge_faces[e * 2 + 1])) is_seam->set(e);
+    }
 }
 
 /**
- * @brief Get all edges incident to a vertex
+ * @brief Mark the vertices of boundary edges as ANCHOR_BOUNDARY
  */
-static std::vector<int> get_vertex_edges(const TopologyInfo* topo, int vertex_idx) {
-    std::vector<int> edges;
+static void mark_boundary_vertices(const TopologyInfo* topo, std::vector<char>* marks) {
+    for (int e = 0; e < topo->num_edges; e++) {
+        if (topo->edge_faces[e * 2 + 1] >= 0) continue;
+        (*marks)[topo->edges[e * 2]] = ANCHOR_BOUNDARY;
+        (*marks)[topo->edges[e * 2 + 1]] = ANCHOR_BOUNDARY;
+    }
+}
+
+/**
+ * @brief Cut of a curvature-weighted maximum spanning tree, pruned to cones
+ */
+static void curvature_mst_seams(const Mesh* mesh, const TopologyInfo* topo,
+                                const std::vector<float>& defects, float defect_threshold,
+                                BitSet* is_seam) {
+    curvature_mst_cut(mesh, topo, is_seam);
+
+    // Cones and boundary vertices may end a cut; everything else is pruned
+    std::vector<char> anchor(mesh->num_vertices, 0);
+    for (int v = 0; v < mesh->num_vertices; v++) {
+        if (defects[v] > defect_threshold) anchor[v] = ANCHOR_CONE;
+    }
+    mark_boundary_vertices(topo, &anchor);
+    prune_cut(topo, anchor, is_seam);
+}
 
-    // TODO: Iterate through all edges, add those touching vertex_idx
+/**
+ * @brief Join the cones to each other and to the boundary by shortest paths
+ *
+ * The MST cut is first pruned back to the boundary alone, which leaves
+ * only the loops a non-disk surface needs (or one edge on a closed
+ * cone-free component). Boundary vertices and that remaining cut form one
+ * terminal, each cone another. A multi-source Dijkstra over edge lengths
+ * grows a region around every terminal; the cheapest edges bridging two
+ * regions are taken in Kruskal order and the paths behind them traced back
+ * (Mehlhorn's Steiner tree approximation).
+ */
+static void shortest_path_seams(const Mesh* mesh, const TopologyInfo* topo,
+                                const std::vector<float>& defects, float defect_threshold,
+                                BitSet* is_seam) {
+    int num_vertices = mesh->num_vertices;
+    int num_edges = topo->num_edges;
 
-    // YOUR CODE HERE
+    curvature_mst_cut(mesh, topo, is_seam);
+    std::vector<char> on_boundary(num_vertices, 0);
+    mark_boundary_vertices(topo, &on_boundary);
+    prune_cut(topo, on_boundary, is_seam);
 
-    return edges;
+    // Terminal 0 = boundary + remaining cut, 1.. = cones off it
+    std::vector<int> source(num_vertices, -1);
+    std::vector<float> dist(num_vertices, INFINITY);
+    std::vector<int> pred_edge(num_vertices, -1);
+    for (int v = 0; v < num_vertices; v++) {
+        if (on_boundary[v]) source[v] = 0;
+    }
+    for (int e = 0; e < num_edges; e++) {
+        if (!is_seam->test(e)) continue;
+        source[topo->edges[e * 2]] = 0;
+        source[topo->edges[e * 2 + 1]] = 0;
+    }
+    int num_terminals = 1;
+    for (int v = 0; v < num_vertices; v++) {
+        if (source[v] < 0 && defects[v] > defect_threshold) source[v] = num_terminals++;
+    }
+    if (num_terminals == 1) return;   // No cone is off the cut already
+
+    typedef std::pair<float, int> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > queue;
+    for (int v = 0; v < num_vertices; v++) {
+        if (source[v] < 0) continue;
+        dist[v] = 0.0f;
+        queue.push(QueueEntry(0.0f, v));
+    }
+
+    while (!queue.empty()) {
+        QueueEntry top = queue.top();
+        queue.pop();
+        int v = top.second;
+        if (top.first > dist[v]) continue;
+
+        for (int i = topo->vertex_edge_offsets[v]; i < topo->vertex_edge_offsets[v + 1]; i++) {
+            int e = topo->vertex_edges[i];
+            int u = topo->edges[e * 2] == v ? topo->edges[e * 2 + 1] : topo->edges[e * 2];
+            float d = dist[v] + edge_length(mesh, topo, e);
+            if (d < dist[u]) {
+                dist[u] = d;
+                source[u] = source[v];
+                pred_edge[u] = e;
+                queue.push(QueueEntry(d, u));
+            }
+        }
+    }
+
+    // Edges between two regions, cheapest connection first
+    std::vector<int> bridges;
+    std::vector<float> cost(num_edges, 0.0f);
+    for (int e = 0; e < num_edges; e++) {
+        int a = topo->edges[e * 2];
+        int b = topo->edges[e * 2 + 1];
+        if (source[a] < 0 || source[b] < 0 || source[a] == source[b]) continue;
+        cost[e] = dist[a] + edge_length(mesh, topo, e) + dist[b];
+        bridges.push_back(e);
+    }
+    std::sort(bridges.begin(), bridges.end(), [&](int x, int y) {
+        return cost[x] < cost[y] || (cost[x] == cost[y] && x < y);
+    });
+
+    auto trace_to_source = [&](int v) {
+        while (pred_edge[v] >= 0) {
+            int p = pred_edge[v];
+            is_seam->set(p);
+            v = topo->edges[p * 2] == v ? topo->edges[p * 2 + 1] : topo->edges[p * 2];
+        }
+    };
+
+    UnionFind terminals(num_terminals);
+    for (int e : bridges) {
+        int a = topo->edges[e * 2];
+        int b = topo->edges[e * 2 + 1];
+        if (!terminals.unite(source[a], source[b])) continue;
+
+        is_seam->set(e);
+        trace_to_source(a);
+        trace_to_source(b);
+    }
+
+    // Only interior edges can be cut
+    for (int e = 0; e < num_edges; e++) {
+        if (topo->edge_faces[e * 2 + 1] < 0) is_seam->reset(e);
+    }
+}
+
+void seam_default_options(SeamOptions* options) {
+    options->angle_threshold = 30.0f;
+    options->mode = SEAM_MODE_SPANNING_TREE;
+    options->num_threads = 0;
 }
 
 int* detect_seams(const Mesh* mesh,
                   const TopologyInfo* topo,
                   float angle_threshold,
                   int* num_seams_out) {
+    SeamOptions options;
+    seam_default_options(&options);
+    options.angle_threshold = angle_threshold;
+    return detect_seams_ex(mesh, topo, &options, num_seams_out);
+}
+
+int* detect_seams_ex(const Mesh* mesh,
+                     const TopologyInfo* topo,
+                     const SeamOptions* options,
+                     int* num_seams_out) {
     if (!mesh || !topo || !num_seams_out) return NULL;
 
-    // TODO: Implement seam detection
-    //
-    // ALGORITHM:
-    //
-    // STEP 1: Build dual graph
-    //   - Nodes = faces
-    //   - Edges = shared edges between faces
-    //   - Use std::vector<std::vector<int>> for adjacency list
-    //
-    // STEP 2: Spanning tree via BFS
-    //   - Start from face 0
-    //   - Mark edges in spanning tree
-    //   - Use std::set<int> to track tree edges
-    //
-    // STEP 3: Initial seam candidates = non-tree edges
-    //   - All edges NOT in spanning tree
-    //
-    // STEP 4: Angular defect refinement
-    //   - For each vertex with high angular defect (> 0.5 radians)
-    //   - Add incident edges to seam candidates
-    //
-    // STEP 5: Convert seam candidates to array
-    //
+    SeamOptions defaults;
+    if (!options) {
+        seam_default_options(&defaults);
+        options = &defaults;
+    }
+
     // Expected seam counts:
     //   Cube: 7-9 seams
     //   Sphere: 1-3 seams
     //   Cylinder: 1-2 seams
 
-    std::set<int> seam_candidates;
+    int num_edges = topo->num_edges;
+
+    // Angular defect = 2π - sum of angles at the vertex (≈ 0 flat, > 0 at
+    // corners, < 0 at saddles), for all vertices in one pass
+    std::vector<float> defects(mesh->num_vertices);
+    compute_angular_defects(mesh, defects.data());
+    float defect_threshold = options->angle_threshold * (float)M_PI / 180.0f;
+
+    BitSet is_seam(num_edges);
+    switch (options->mode) {
+    case SEAM_MODE_SPANNING_TREE:
+        spanning_tree_seams(mesh, topo, defects, defect_threshold,
+                            resolve_num_threads(options->num_threads), &is_seam);
+        break;
+    case SEAM_MODE_CURVATURE_MST:
+        curvature_mst_seams(mesh, topo, defects, defect_threshold, &is_seam);
+        break;
+    case SEAM_MODE_SHORTEST_PATH:
+        shortest_path_seams(mesh, topo, defects, defect_threshold, &is_seam);
+        break;
+    default:
+        fprintf(stderr, "detect_seams_ex: Unknown seam mode %d\n", options->mode);
+        return NULL;
+    }
 
-    // YOUR CODE HERE
+    // Convert seam candidates to array (in edge order)
+    int num_seams = (int)is_seam.count();
 
-    // Convert to array
-    *num_seams_out = seam_candidates.size();
-    int* seams = (int*)malloc(*num_seams_out * sizeof(int));
+    *num_seams_out = num_seams;
+    int* seams = (int*)malloc(((size_t)num_seams + 1) * sizeof(int));
 
     int idx = 0;
-    for (int edge_idx : seam_candidates) {
-        seams[idx++] = edge_idx;
+    for (int e = 0; e < num_edges; e++) {
+        if (is_seam.test(e)) seams[idx++] = e;
     }
 
     printf("Detected %d seams\n", *num_seams_out);
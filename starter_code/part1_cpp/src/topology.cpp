@@ -2,88 +2,348 @@
  * @file topology.cpp
  * @brief Topology builder implementation
  *
- * SKELETON - YOU IMPLEMENT THIS
- *
  * Algorithm:
- * 1. Extract all edges from triangles
- * 2. Ensure uniqueness (always store as v0 < v1)
- * 3. For each edge, find adjacent faces
- * 4. Validate using Euler characteristic
+ * 1. Emit one packed 64-bit key (v0 << bits | v1, v0 < v1) per triangle
+ *    corner, with the corner index (face * 3 + k) alongside
+ * 2. Radix sort the keys; the sort is stable, so equal keys stay in face
+ *    order
+ * 3. Sweep the sorted keys once: each run of equal keys is one edge, its
+ *    first two faces are face0/face1, and every corner in the run records
+ *    the edge in face_edges
+ * 4. Count degrees and fill the vertex→edge / vertex→face CSR tables
+ * 5. Validate using Euler characteristic
+ *
+ * Edges come out in (v0, v1) order, the same order a std::map<Edge, ...>
+ * would produce, but with two flat arrays instead of a heap node per edge.
  *
- * See reference/topology_example.cpp for guidance
+ * With several threads, keys are first scattered into partitions by ranges
+ * of v0, each partition is sorted and swept on its own, and the partitions
+ * are laid out in v0 order, so the result matches the serial build exactly.
  */
 
 #include "topology.h"
+#include "parallel.h"
 #include <stdlib.h>
 #include <stdio.h>
-#include <map>
+#include <string.h>
+#include <stdint.h>
+#include <algorithm>
 #include <vector>
 
+#define EDGE_RADIX_BITS 11
+#define EDGE_RADIX_SIZE (1 << EDGE_RADIX_BITS)
+
+// Below this, thread start-up costs more than it saves
+#define TOPOLOGY_PARALLEL_MIN_TRIANGLES 65536
+
 /**
- * @brief Edge structure for uniqueness
+ * @brief Number of bits needed to store values in [0, n)
+ */
+static int bits_for_count(int n) {
+    int bits = 1;
+    while (bits < 31 && ((int64_t)1 << bits) < n) bits++;
+    return bits;
+}
+
+/**
+ * @brief Stable LSD radix sort of keys (and their corners) on the low key_bits
+ *
+ * Sorted data ends up back in keys/corners; tmp_keys/tmp_corners are scratch.
  */
-struct Edge {
-    int v0, v1;
-
-    Edge(int a, int b) {
-        // Always store smaller vertex first
-        if (a < b) {
-            v0 = a;
-            v1 = b;
-        } else {
-            v0 = b;
-            v1 = a;
+static void radix_sort_edges(uint64_t* keys, int* corners,
+                             uint64_t* tmp_keys, int* tmp_corners,
+                             size_t n, int key_bits) {
+    std::vector<size_t> count(EDGE_RADIX_SIZE);
+
+    for (int shift = 0; shift < key_bits; shift += EDGE_RADIX_BITS) {
+        std::fill(count.begin(), count.end(), 0);
+        for (size_t i = 0; i < n; i++) {
+            count[(keys[i] >> shift) & (EDGE_RADIX_SIZE - 1)]++;
+        }
+
+        size_t sum = 0;
+        for (int d = 0; d < EDGE_RADIX_SIZE; d++) {
+            size_t c = count[d];
+            count[d] = sum;
+            sum += c;
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            size_t dst = count[(keys[i] >> shift) & (EDGE_RADIX_SIZE - 1)]++;
+            tmp_keys[dst] = keys[i];
+            tmp_corners[dst] = corners[i];
         }
+
+        std::swap(keys, tmp_keys);
+        std::swap(corners, tmp_corners);
     }
 
-    bool operator<(const Edge& other) const {
-        if (v0 != other.v0) return v0 < other.v0;
-        return v1 < other.v1;
+    // An odd number of passes leaves the result in the scratch buffers
+    int passes = (key_bits + EDGE_RADIX_BITS - 1) / EDGE_RADIX_BITS;
+    if (passes % 2 == 1) {
+        memcpy(tmp_keys, keys, n * sizeof(uint64_t));
+        memcpy(tmp_corners, corners, n * sizeof(int));
     }
-};
+}
 
 /**
- * @brief Edge information
+ * @brief Edge key of corner k of a triangle (v0 < v1 packed into 64 bits)
  */
-struct EdgeInfo {
-    int face0;
-    int face1;
+static inline uint64_t corner_edge_key(const int* tri, int k, int vertex_bits) {
+    int a = tri[k];
+    int b = tri[k == 2 ? 0 : k + 1];
+    uint64_t v0 = (uint64_t)(a < b ? a : b);
+    uint64_t v1 = (uint64_t)(a < b ? b : a);
+    return (v0 << vertex_bits) | v1;
+}
 
-    EdgeInfo() : face0(-1), face1(-1) {}
-};
+/**
+ * @brief Counting-sort style CSR fill of the vertex→edge and vertex→face tables
+ *
+ * Edges and faces are pushed in increasing order, so every row is sorted.
+ */
+static void build_vertex_tables(const Mesh* mesh, TopologyInfo* topo) {
+    int nv = mesh->num_vertices;
+    int ne = topo->num_edges;
+    int nf = mesh->num_triangles;
+
+    free(topo->vertex_edge_offsets);
+    free(topo->vertex_edges);
+    free(topo->vertex_face_offsets);
+    free(topo->vertex_faces);
+
+    int* edge_offsets = (int*)calloc((size_t)nv + 1, sizeof(int));
+    int* face_offsets = (int*)calloc((size_t)nv + 1, sizeof(int));
+    int* vertex_edges = (int*)malloc((size_t)ne * 2 * sizeof(int));
+    int* vertex_faces = (int*)malloc((size_t)nf * 3 * sizeof(int));
+
+    for (int e = 0; e < ne; e++) {
+        edge_offsets[topo->edges[e * 2] + 1]++;
+        edge_offsets[topo->edges[e * 2 + 1] + 1]++;
+    }
+    for (size_t c = 0; c < (size_t)nf * 3; c++) {
+        face_offsets[mesh->triangles[c] + 1]++;
+    }
+    for (int v = 0; v < nv; v++) {
+        edge_offsets[v + 1] += edge_offsets[v];
+        face_offsets[v + 1] += face_offsets[v];
+    }
+
+    // Fill using the row starts as cursors, then shift them back
+    std::vector<int> cursor(edge_offsets, edge_offsets + nv);
+    for (int e = 0; e < ne; e++) {
+        vertex_edges[cursor[topo->edges[e * 2]]++] = e;
+        vertex_edges[cursor[topo->edges[e * 2 + 1]]++] = e;
+    }
+    cursor.assign(face_offsets, face_offsets + nv);
+    for (size_t c = 0; c < (size_t)nf * 3; c++) {
+        vertex_faces[cursor[mesh->triangles[c]]++] = (int)(c / 3);
+    }
+
+    topo->vertex_edge_offsets = edge_offsets;
+    topo->vertex_edges = vertex_edges;
+    topo->vertex_face_offsets = face_offsets;
+    topo->vertex_faces = vertex_faces;
+}
+
+/**
+ * @brief Index of edge (a, b) via the smaller vertex's CSR row, or -1
+ */
+static int find_edge(const TopologyInfo* topo, int a, int b) {
+    int v0 = a < b ? a : b;
+    int v1 = a < b ? b : a;
+    for (int i = topo->vertex_edge_offsets[v0]; i < topo->vertex_edge_offsets[v0 + 1]; i++) {
+        int e = topo->vertex_edges[i];
+        if (topo->edges[e * 2] == v0 && topo->edges[e * 2 + 1] == v1) return e;
+    }
+    return -1;
+}
 
 TopologyInfo* build_topology(const Mesh* mesh) {
-    if (!mesh) return NULL;
-
-    // TODO: Implement topology building
-    //
-    // Steps:
-    // 1. Create std::map<Edge, EdgeInfo> to collect edges
-    // 2. Iterate through all triangles
-    //    For each triangle, extract 3 edges
-    //    Add to map, tracking which faces use each edge
-    // 3. Convert map to arrays (edges, edge_faces)
-    // 4. Allocate TopologyInfo and fill arrays
-    //
-    // Hints:
-    // - Use Edge struct for automatic ordering
-    // - Each edge should have 1 or 2 adjacent faces
-    // - Boundary edges have only 1 face (set face1 = -1)
-    //
-    // See reference/topology_example.cpp for complete example
+    return build_topology_ex(mesh, 0);
+}
+
+TopologyInfo* build_topology_ex(const Mesh* mesh, int num_threads) {
+    if (!mesh || !mesh->triangles || mesh->num_vertices <= 0) return NULL;
+
+    int num_triangles = mesh->num_triangles;
+    int num_vertices = mesh->num_vertices;
+    size_t num_corners = (size_t)num_triangles * 3;
+    int vertex_bits = bits_for_count(num_vertices);
+
+    num_threads = resolve_num_threads(num_threads);
+    if (num_triangles < TOPOLOGY_PARALLEL_MIN_TRIANGLES) num_threads = 1;
+
+    // Triangles are split into one contiguous block per thread; keys are
+    // bucketed into partitions by contiguous ranges of the smaller vertex,
+    // several per thread so uneven ranges still balance
+    int num_blocks = num_threads;
+    int num_parts = num_threads == 1 ? 1 : num_threads * 4;
+    std::vector<size_t> counts((size_t)num_blocks * num_parts, 0);
+    std::vector<int> invalid_face(num_blocks, -1);
+
+    auto block_range = [&](int b, int* first, int* last) {
+        *first = (int)((int64_t)num_triangles * b / num_blocks);
+        *last = (int)((int64_t)num_triangles * (b + 1) / num_blocks);
+    };
+    auto part_of = [&](uint64_t key) {
+        return (int)(((key >> vertex_bits) * (uint64_t)num_parts) / (uint64_t)num_vertices);
+    };
+
+    // 1. Count keys per (block, partition)
+    parallel_for(num_blocks, num_threads, [&](int b) {
+        int first, last;
+        block_range(b, &first, &last);
+        size_t* count = &counts[(size_t)b * num_parts];
+        for (int f = first; f < last; f++) {
+            const int* tri = mesh->triangles + (size_t)f * 3;
+            if (tri[0] < 0 || tri[1] < 0 || tri[2] < 0 ||
+                tri[0] >= num_vertices || tri[1] >= num_vertices || tri[2] >= num_vertices) {
+                if (invalid_face[b] < 0) invalid_face[b] = f;
+                continue;
+            }
+            for (int k = 0; k < 3; k++) count[part_of(corner_edge_key(tri, k, vertex_bits))]++;
+        }
+    });
+
+    for (int b = 0; b < num_blocks; b++) {
+        if (invalid_face[b] >= 0) {
+            fprintf(stderr, "build_topology: Face %d has invalid vertex index\n", invalid_face[b]);
+            return NULL;
+        }
+    }
+
+    // Partition-major offsets; within a partition, blocks (and so faces)
+    // stay in order
+    std::vector<size_t> offsets((size_t)num_blocks * num_parts);
+    std::vector<size_t> part_begin(num_parts + 1);
+    size_t sum = 0;
+    for (int p = 0; p < num_parts; p++) {
+        part_begin[p] = sum;
+        for (int b = 0; b < num_blocks; b++) {
+            offsets[(size_t)b * num_parts + p] = sum;
+            sum += counts[(size_t)b * num_parts + p];
+        }
+    }
+    part_begin[num_parts] = sum;
+
+    // 2. Scatter keys into their partitions
+    std::vector<uint64_t> keys(num_corners);
+    std::vector<int> corners(num_corners);
+    parallel_for(num_blocks, num_threads, [&](int b) {
+        int first, last;
+        block_range(b, &first, &last);
+        size_t* pos = &offsets[(size_t)b * num_parts];
+        for (int f = first; f < last; f++) {
+            const int* tri = mesh->triangles + (size_t)f * 3;
+            for (int k = 0; k < 3; k++) {
+                uint64_t key = corner_edge_key(tri, k, vertex_bits);
+                size_t dst = pos[part_of(key)]++;
+                keys[dst] = key;
+                corners[dst] = f * 3 + k;
+            }
+        }
+    });
+
+    // 3. Sort each partition and count its edges
+    std::vector<int> part_edges(num_parts + 1, 0);
+    {
+        std::vector<uint64_t> tmp_keys(num_corners);
+        std::vector<int> tmp_corners(num_corners);
+        parallel_for(num_parts, num_threads, [&](int p) {
+            size_t begin = part_begin[p];
+            size_t end = part_begin[p + 1];
+            radix_sort_edges(&keys[begin], &corners[begin], &tmp_keys[begin], &tmp_corners[begin],
+                             end - begin, vertex_bits * 2);
 
+            int n = 0;
+            for (size_t i = begin; i < end; i++) {
+                if (i == begin || keys[i] != keys[i - 1]) n++;
+            }
+            part_edges[p + 1] = n;
+        });
+    }
+    for (int p = 0; p < num_parts; p++) part_edges[p + 1] += part_edges[p];
+
+    // 4. Sweep each partition into its slice of the edge arrays
+    int num_edges = part_edges[num_parts];
     TopologyInfo* topo = (TopologyInfo*)malloc(sizeof(TopologyInfo));
+    topo->num_edges = num_edges;
+    topo->edges = (int*)malloc((size_t)num_edges * 2 * sizeof(int));
+    topo->edge_faces = (int*)malloc((size_t)num_edges * 2 * sizeof(int));
+    topo->num_vertices = num_vertices;
+    topo->num_faces = num_triangles;
+    topo->vertex_edge_offsets = NULL;
+    topo->vertex_edges = NULL;
+    topo->vertex_face_offsets = NULL;
+    topo->vertex_faces = NULL;
+    topo->face_edges = (int*)malloc(num_corners * sizeof(int));
+
+    uint64_t v1_mask = ((uint64_t)1 << vertex_bits) - 1;
+    parallel_for(num_parts, num_threads, [&](int p) {
+        size_t begin = part_begin[p];
+        size_t end = part_begin[p + 1];
+        int e = part_edges[p] - 1;
+        for (size_t i = begin; i < end; i++) {
+            if (i == begin || keys[i] != keys[i - 1]) {
+                e++;
+                topo->edges[e * 2] = (int)(keys[i] >> vertex_bits);
+                topo->edges[e * 2 + 1] = (int)(keys[i] & v1_mask);
+                topo->edge_faces[e * 2] = corners[i] / 3;
+                topo->edge_faces[e * 2 + 1] = -1;
+            } else if (topo->edge_faces[e * 2 + 1] < 0) {
+                // Non-manifold edges keep their first two faces
+                topo->edge_faces[e * 2 + 1] = corners[i] / 3;
+            }
+            topo->face_edges[corners[i]] = e;
+        }
+    });
 
-    // YOUR CODE HERE
+    // 5. Vertex adjacency
+    build_vertex_tables(mesh, topo);
 
     return topo;
 }
 
+int build_topology_adjacency(const Mesh* mesh, TopologyInfo* topo) {
+    if (!mesh || !topo) return -1;
+
+    topo->num_vertices = mesh->num_vertices;
+    topo->num_faces = mesh->num_triangles;
+    if (!topo->vertex_edge_offsets || !topo->vertex_face_offsets) {
+        build_vertex_tables(mesh, topo);
+    }
+    if (topo->face_edges) return 0;
+
+    // Each side's edge is in its smaller vertex's list
+    topo->face_edges = (int*)malloc((size_t)mesh->num_triangles * 3 * sizeof(int));
+    for (int f = 0; f < mesh->num_triangles; f++) {
+        const int* tri = mesh->triangles + (size_t)f * 3;
+        for (int k = 0; k < 3; k++) {
+            int a = tri[k];
+            int b = tri[k == 2 ? 0 : k + 1];
+            int e = find_edge(topo, a, b);
+            if (e < 0) {
+                fprintf(stderr, "build_topology_adjacency: No edge for face %d side %d\n", f, k);
+                return -1;
+            }
+            topo->face_edges[(size_t)f * 3 + k] = e;
+        }
+    }
+
+    return 0;
+}
+
 void free_topology(TopologyInfo* topo) {
     if (!topo) return;
 
     if (topo->edges) free(topo->edges);
     if (topo->edge_faces) free(topo->edge_faces);
+    if (topo->vertex_edge_offsets) free(topo->vertex_edge_offsets);
+    if (topo->vertex_edges) free(topo->vertex_edges);
+    if (topo->vertex_face_offsets) free(topo->vertex_face_offsets);
+    if (topo->vertex_faces) free(topo->vertex_faces);
+    if (topo->face_edges) free(topo->face_edges);
     free(topo);
 }
 
@@ -0,0 +1,69 @@
+/**
+ * @file union_find.h
+ * @brief Disjoint-set forest over dense integer ids
+ *
+ * INTERNAL - not installed with the public headers
+ */
+
+#ifndef UNION_FIND_H
+#define UNION_FIND_H
+
+#include <vector>
+
+/**
+ * @brief Union by size with path halving
+ *
+ * Not thread-safe.
+ */
+struct UnionFind {
+    std::vector<int> parent;
+    std::vector<int> size;
+
+    explicit UnionFind(int n) : parent(n), size(n, 1) {
+        for (int i = 0; i < n; i++) parent[i] = i;
+    }
+
+    int find(int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    /**
+     * @return 1 if a and b were in different sets (now merged), 0 otherwise
+     */
+    int unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return 0;
+        if (size[a] < size[b]) {
+            int t = a;
+            a = b;
+            b = t;
+        }
+        parent[b] = a;
+        size[a] += size[b];
+        return 1;
+    }
+
+    /**
+     * @brief Merge the set of child into the set of root, keeping root's
+     *        representative regardless of size
+     *
+     * For callers whose own bookkeeping is keyed by the surviving root.
+     *
+     * @return 1 if they were in different sets (now merged), 0 otherwise
+     */
+    int attach(int child, int root) {
+        child = find(child);
+        root = find(root);
+        if (child == root) return 0;
+        parent[child] = root;
+        size[root] += size[child];
+        return 1;
+    }
+};
+
+#endif /* UNION_FIND_H */
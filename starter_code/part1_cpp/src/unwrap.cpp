@@ -2,8 +2,6 @@
  * @file unwrap.cpp
  * @brief Main UV unwrapping orchestrator
  *
- * SKELETON - YOU IMPLEMENT THIS
- *
  * This file ties together all the components:
  * - Topology building
  * - Seam detection
@@ -14,16 +12,26 @@
 
 #include "unwrap.h"
 #include "lscm.h"
+#include "mesh_repair.h"
+#include "math_utils.h"
+#include "bitset.h"
+#include "union_find.h"
+#include "parallel.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
 #include <vector>
-#include <set>
-#include <map>
 
 /**
  * @brief Extract UV islands after seam cuts
  *
- * Uses connected components algorithm on face graph after removing seam edges.
+ * Connected components of the face graph without seam edges, labelled
+ * with union-find over the non-seam interior edges. Islands are numbered
+ * in order of their lowest face.
  *
  * @param mesh Input mesh
  * @param topo Topology info
@@ -37,53 +45,213 @@ static int* extract_islands(const Mesh* mesh,
                            const int* seam_edges,
                            int num_seams,
                            int* num_islands_out) {
-    // TODO: Implement island extraction
-    //
-    // Algorithm:
-    // 1. Build face adjacency graph (faces connected by non-seam edges)
-    // 2. Run connected components (BFS or DFS)
-    // 3. Assign island ID to each face
-    //
-    // Steps:
-    // 1. Create std::set<int> of seam edge indices for fast lookup
-    // 2. Build adjacency list for faces (only through non-seam edges)
-    // 3. Run BFS/DFS to find connected components
-    // 4. Return array of island IDs (one per face)
+    int num_faces = mesh->num_triangles;
 
-    int* face_island_ids = (int*)malloc(mesh->num_triangles * sizeof(int));
+    BitSet is_seam(topo->num_edges);
+    for (int i = 0; i < num_seams; i++) {
+        is_seam.set(seam_edges[i]);
+    }
 
-    // Initialize all to -1 (unvisited)
-    for (int i = 0; i < mesh->num_triangles; i++) {
-        face_island_ids[i] = -1;
+    UnionFind components(num_faces);
+    for (int e = 0; e < topo->num_edges; e++) {
+        if (topo->edge_faces[e * 2 + 1] < 0 || is_seam.test(e)) continue;
+        components.unite(topo->edge_faces[e * 2], topo->edge_faces[e * 2 + 1]);
     }
 
-    // YOUR CODE HERE
+    // Compact ids: a root gets the next id when its lowest face is reached
+    int* face_island_ids = (int*)malloc((size_t)num_faces * sizeof(int));
+    std::vector<int> root_island(num_faces, -1);
+    int num_islands = 0;
+    for (int f = 0; f < num_faces; f++) {
+        int root = components.find(f);
+        if (root_island[root] < 0) root_island[root] = num_islands++;
+        face_island_ids[f] = root_island[root];
+    }
 
-    *num_islands_out = 0;  // Update this with actual count
+    *num_islands_out = num_islands;
 
     printf("Extracted %d UV islands\n", *num_islands_out);
 
     return face_island_ids;
 }
 
+/**
+ * @brief Merge islands smaller than min_faces into a neighbouring island
+ *
+ * Undersized islands are taken smallest first and absorbed by the island
+ * they share the longest seam with, until none is left that has a
+ * neighbour. The island adjacency graph (seam length per island pair) is
+ * kept up to date as islands merge. Ids are then compacted again in order
+ * of each island's lowest face.
+ *
+ * @param mesh Input mesh
+ * @param topo Topology info
+ * @param face_island_ids Island ID per face (updated in place)
+ * @param num_islands Number of islands before merging
+ * @param min_faces Minimum island size
+ * @return Number of islands after merging
+ */
+static int merge_small_islands(const Mesh* mesh,
+                               const TopologyInfo* topo,
+                               int* face_island_ids,
+                               int num_islands,
+                               int min_faces) {
+    if (min_faces <= 1 || num_islands <= 1) return num_islands;
+
+    int num_faces = mesh->num_triangles;
+    std::vector<int> size(num_islands, 0);
+    for (int f = 0; f < num_faces; f++) size[face_island_ids[f]]++;
+
+    // Seam length shared with each neighbouring island
+    std::vector<std::unordered_map<int, float> > adjacent(num_islands);
+    for (int e = 0; e < topo->num_edges; e++) {
+        int f0 = topo->edge_faces[e * 2];
+        int f1 = topo->edge_faces[e * 2 + 1];
+        if (f1 < 0) continue;
+        int a = face_island_ids[f0];
+        int b = face_island_ids[f1];
+        if (a == b) continue;
+        Vec3 p = get_vertex_position(mesh, topo->edges[e * 2]);
+        Vec3 q = get_vertex_position(mesh, topo->edges[e * 2 + 1]);
+        float length = vec3_length(vec3_sub(q, p));
+        adjacent[a][b] += length;
+        adjacent[b][a] += length;
+    }
+
+    typedef std::pair<int, int> QueueEntry;     // (size, island)
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > queue;
+    for (int i = 0; i < num_islands; i++) {
+        if (size[i] < min_faces) queue.push(QueueEntry(size[i], i));
+    }
+
+    UnionFind merged(num_islands);
+    int num_merges = 0;
+    while (!queue.empty()) {
+        QueueEntry top = queue.top();
+        queue.pop();
+        int island = top.second;
+        if (merged.find(island) != island || size[island] != top.first) continue;   // Stale
+        if (size[island] >= min_faces || adjacent[island].empty()) continue;
+
+        // Longest shared seam; ties go to the lower id
+        int target = -1;
+        float best = -1.0f;
+        for (const auto& entry : adjacent[island]) {
+            if (entry.second > best || (entry.second == best && entry.first < target)) {
+                best = entry.second;
+                target = entry.first;
+            }
+        }
+
+        // island's edges move to target; target stays the root
+        merged.attach(island, target);
+        size[target] += size[island];
+        adjacent[target].erase(island);
+        for (const auto& entry : adjacent[island]) {
+            if (entry.first == target) continue;
+            adjacent[target][entry.first] += entry.second;
+            adjacent[entry.first].erase(island);
+            adjacent[entry.first][target] += entry.second;
+        }
+        adjacent[island].clear();
+        num_merges++;
+
+        if (size[target] < min_faces) queue.push(QueueEntry(size[target], target));
+    }
+
+    if (num_merges == 0) return num_islands;
+
+    std::vector<int> new_id(num_islands, -1);
+    int count = 0;
+    for (int f = 0; f < num_faces; f++) {
+        int root = merged.find(face_island_ids[f]);
+        if (new_id[root] < 0) new_id[root] = count++;
+        face_island_ids[f] = new_id[root];
+    }
+
+    printf("Merged %d small islands, %d islands left\n", num_merges, count);
+
+    return count;
+}
+
+/**
+ * @brief Group faces by island with a counting sort
+ *
+ * The faces of island i are
+ * island_faces[island_offsets[i] .. island_offsets[i + 1]), in increasing
+ * order.
+ *
+ * @param island_offsets_out Output: island starts (num_islands + 1)
+ * @param island_faces_out Output: faces grouped by island (num_faces)
+ * @note Caller must free both output arrays
+ */
+static void group_faces_by_island(const int* face_island_ids,
+                                  int num_faces,
+                                  int num_islands,
+                                  int** island_offsets_out,
+                                  int** island_faces_out) {
+    int* offsets = (int*)calloc((size_t)num_islands + 1, sizeof(int));
+    int* faces = (int*)malloc((size_t)num_faces * sizeof(int));
+
+    for (int f = 0; f < num_faces; f++) offsets[face_island_ids[f] + 1]++;
+    for (int i = 0; i < num_islands; i++) offsets[i + 1] += offsets[i];
+
+    std::vector<int> cursor(offsets, offsets + num_islands);
+    for (int f = 0; f < num_faces; f++) faces[cursor[face_island_ids[f]]++] = f;
+
+    *island_offsets_out = offsets;
+    *island_faces_out = faces;
+}
+
 /**
  * @brief Copy UVs from island parameterization to result mesh
+ *
+ * Only vertices owned by this island are written, so islands sharing seam
+ * vertices can be copied concurrently.
+ *
+ * @param corner_local Island-local vertex index per corner of face_indices
+ * @param owner Island that writes each mesh vertex
+ * @param island_id This island
  */
 static void copy_island_uvs(Mesh* result,
                            const float* island_uvs,
                            const int* face_indices,
                            int num_faces,
-                           const std::map<int, int>& global_to_local) {
-    // TODO: Implement UV copying
-    //
-    // For each face in the island:
-    //   For each vertex in the face:
-    //     global_idx = vertex index in mesh
-    //     local_idx = global_to_local[global_idx]
-    //     result->uvs[global_idx * 2] = island_uvs[local_idx * 2]
-    //     result->uvs[global_idx * 2 + 1] = island_uvs[local_idx * 2 + 1]
-
-    // YOUR CODE HERE
+                           const int* corner_local,
+                           const int* owner,
+                           int island_id) {
+    for (int i = 0; i < num_faces; i++) {
+        for (int k = 0; k < 3; k++) {
+            int global_idx = result->triangles[face_indices[i] * 3 + k];
+            if (owner[global_idx] != island_id) continue;
+            int local_idx = corner_local[i * 3 + k];
+            result->uvs[global_idx * 2] = island_uvs[local_idx * 2];
+            result->uvs[global_idx * 2 + 1] = island_uvs[local_idx * 2 + 1];
+        }
+    }
+}
+
+/**
+ * @brief Printable name of a SeamMode
+ */
+static const char* seam_mode_name(int mode) {
+    switch (mode) {
+    case SEAM_MODE_SPANNING_TREE: return "spanning tree";
+    case SEAM_MODE_CURVATURE_MST: return "curvature MST";
+    case SEAM_MODE_SHORTEST_PATH: return "shortest path";
+    default: return "unknown";
+    }
+}
+
+void unwrap_default_params(UnwrapParams* params) {
+    params->angle_threshold = 30.0f;
+    params->min_island_faces = 10;
+    params->pack_islands = 1;
+    params->island_margin = 0.02f;
+    params->weld_epsilon = 0.0f;
+    params->seam_mode = SEAM_MODE_SPANNING_TREE;
+    params->num_threads = 0;
+    params->lscm_context = NULL;
 }
 
 Mesh* unwrap_mesh(const Mesh* mesh,
@@ -99,57 +267,170 @@ Mesh* unwrap_mesh(const Mesh* mesh,
            mesh->num_vertices, mesh->num_triangles);
     printf("Parameters:\n");
     printf("  Angle threshold: %.1f°\n", params->angle_threshold);
+    printf("  Seam mode: %s\n", seam_mode_name(params->seam_mode));
     printf("  Min island faces: %d\n", params->min_island_faces);
     printf("  Pack islands: %s\n", params->pack_islands ? "yes" : "no");
     printf("  Island margin: %.3f\n", params->island_margin);
+    if (params->weld_epsilon > 0.0f) {
+        printf("  Weld epsilon: %g\n", params->weld_epsilon);
+    }
     printf("\n");
 
-    // TODO: Implement main unwrapping pipeline
-    //
+    // STEP 0: Weld coincident vertices, so faces that only touch through
+    // duplicated vertices end up in one island
+    Mesh* welded = NULL;
+    if (params->weld_epsilon > 0.0f) {
+        WeldStats stats;
+        welded = weld_mesh(mesh, params->weld_epsilon, &stats);
+        if (!welded) {
+            fprintf(stderr, "Failed to weld mesh\n");
+            return NULL;
+        }
+        printf("Welded %d vertices, removed %d degenerate and %d duplicate triangles\n",
+               stats.merged_vertices, stats.degenerate_triangles, stats.duplicate_triangles);
+        mesh = welded;
+    }
+
     // STEP 1: Build topology
     TopologyInfo* topo = build_topology(mesh);
     if (!topo) {
         fprintf(stderr, "Failed to build topology\n");
+        free_mesh(welded);
         return NULL;
     }
     validate_topology(mesh, topo);
 
     // STEP 2: Detect seams
+    SeamOptions seam_options;
+    seam_default_options(&seam_options);
+    seam_options.angle_threshold = params->angle_threshold;
+    seam_options.mode = params->seam_mode;
+    seam_options.num_threads = params->num_threads;
+
     int num_seams;
-    int* seam_edges = detect_seams(mesh, topo, params->angle_threshold, &num_seams);
+    int* seam_edges = detect_seams_ex(mesh, topo, &seam_options, &num_seams);
+    if (!seam_edges) {
+        fprintf(stderr, "Failed to detect seams\n");
+        free_topology(topo);
+        free_mesh(welded);
+        return NULL;
+    }
 
     // STEP 3: Extract islands
     int num_islands;
     int* face_island_ids = extract_islands(mesh, topo, seam_edges, num_seams, &num_islands);
+    num_islands = merge_small_islands(mesh, topo, face_island_ids, num_islands,
+                                      params->min_island_faces);
 
     // STEP 4: Parameterize each island using LSCM
     Mesh* result = allocate_mesh_copy(mesh);
     result->uvs = (float*)calloc(mesh->num_vertices * 2, sizeof(float));
 
-    for (int island_id = 0; island_id < num_islands; island_id++) {
-        printf("\nProcessing island %d/%d...\n", island_id + 1, num_islands);
+    // Faces grouped by island once (CSR), so each face is visited once below
+    int* island_offsets;
+    int* island_faces;
+    group_faces_by_island(face_island_ids, mesh->num_triangles, num_islands,
+                          &island_offsets, &island_faces);
 
-        // Get faces in this island
-        std::vector<int> island_faces;
-        for (int f = 0; f < mesh->num_triangles; f++) {
-            if (face_island_ids[f] == island_id) {
-                island_faces.push_back(f);
+    // Island-local index of every corner, in lscm_parameterize() order
+    // (first appearance in the face list), and the island that writes each
+    // vertex's UV: the highest one touching it, as a serial loop would leave
+    std::vector<int> corner_local((size_t)mesh->num_triangles * 3);
+    std::vector<int> owner(mesh->num_vertices, -1);
+    {
+        std::vector<int> local_index(mesh->num_vertices, -1);
+        for (int island_id = 0; island_id < num_islands; island_id++) {
+            int begin = island_offsets[island_id] * 3;
+            int end = island_offsets[island_id + 1] * 3;
+            int num_local = 0;
+            for (int i = begin; i < end; i++) {
+                int v = mesh->triangles[island_faces[i / 3] * 3 + i % 3];
+                if (local_index[v] < 0) local_index[v] = num_local++;
+                corner_local[i] = local_index[v];
+                owner[v] = island_id;
+            }
+            for (int i = begin; i < end; i++) {
+                local_index[mesh->triangles[island_faces[i / 3] * 3 + i % 3]] = -1;
             }
         }
+    }
 
-        printf("  %d faces in island\n", (int)island_faces.size());
+    // Largest islands first, so a big one never starts last
+    std::vector<int> order(num_islands);
+    for (int i = 0; i < num_islands; i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](int x, int y) {
+        return island_offsets[x + 1] - island_offsets[x] > island_offsets[y + 1] - island_offsets[y];
+    });
+
+    // Islands big enough to assemble in parallel (a prefix of order) are
+    // solved one at a time with every worker; the rest are spread over
+    // workers, one island each
+    int num_threads = resolve_num_threads(params->num_threads);
+    int num_large = 0;
+    while (num_large < num_islands &&
+           island_offsets[order[num_large] + 1] - island_offsets[order[num_large]] >=
+               LSCM_PARALLEL_MIN_TRIANGLES) {
+        num_large++;
+    }
 
-        if (island_faces.size() < params->min_island_faces) {
-            printf("  Skipping (too small)\n");
-            continue;
+    LSCMOptions lscm_options;
+    lscm_default_options(&lscm_options);
+    lscm_options.context = params->lscm_context;
+
+    // Returns 0 (and leaves the island at (0, 0)) if LSCM fails
+    auto solve_island = [&](int island_id, const LSCMOptions* options, LSCMStats* stats) {
+        const int* faces = island_faces + island_offsets[island_id];
+        int num_faces = island_offsets[island_id + 1] - island_offsets[island_id];
+        float* island_uvs = lscm_parameterize_ex(mesh, faces, num_faces, options, stats);
+        if (!island_uvs) return 0;
+
+        copy_island_uvs(result, island_uvs, faces, num_faces,
+                        corner_local.data() + (size_t)island_offsets[island_id] * 3,
+                        owner.data(), island_id);
+        free(island_uvs);
+        return 1;
+    };
+
+    lscm_options.num_threads = num_threads;
+    for (int task = 0; task < num_large; task++) {
+        int island_id = order[task];
+        printf("Processing island %d/%d: %d faces\n", island_id + 1, num_islands,
+               island_offsets[island_id + 1] - island_offsets[island_id]);
+        if (!solve_island(island_id, &lscm_options, NULL)) {
+            printf("  LSCM failed, island %d left at (0, 0)\n", island_id + 1);
         }
+    }
 
-        // YOUR CODE HERE:
-        // - Call lscm_parameterize
-        // - Build global_to_local mapping
-        // - Copy UVs to result mesh
+    // Islands are independent and write disjoint vertices, so workers take
+    // them from a shared counter with no locking. Workers print nothing;
+    // the calling thread reports each island afterwards, in order.
+    std::vector<LSCMStats> island_stats(num_islands);
+    std::vector<char> island_solved(num_islands, 0);
+    lscm_options.num_threads = 1;
+    lscm_options.verbose = 0;
+    parallel_for(num_islands - num_large, num_threads, [&](int task) {
+        int island_id = order[num_large + task];
+        island_solved[island_id] = (char)solve_island(island_id, &lscm_options,
+                                                      &island_stats[island_id]);
+    });
+
+    for (int island_id = 0; island_id < num_islands; island_id++) {
+        int num_faces = island_offsets[island_id + 1] - island_offsets[island_id];
+        if (num_faces >= LSCM_PARALLEL_MIN_TRIANGLES) continue;
+        if (!island_solved[island_id]) {
+            printf("Island %d/%d: %d faces, LSCM failed, left at (0, 0)\n",
+                   island_id + 1, num_islands, num_faces);
+        } else {
+            const LSCMStats& stats = island_stats[island_id];
+            printf("Island %d/%d: %d faces, %d vertices, solved in %.3f s\n",
+                   island_id + 1, num_islands, num_faces, stats.num_vertices,
+                   stats.assembly_seconds + stats.solve_seconds);
+        }
     }
 
+    free(island_offsets);
+    free(island_faces);
+
     // STEP 5: Pack islands if requested
     if (params->pack_islands) {
         UnwrapResult temp_result;
@@ -170,6 +451,7 @@ Mesh* unwrap_mesh(const Mesh* mesh,
     // Cleanup
     free_topology(topo);
     free(seam_edges);
+    free_mesh(welded);
 
     printf("\n=== Unwrapping Complete ===\n");
 
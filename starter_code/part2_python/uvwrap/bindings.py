@@ -64,6 +64,10 @@ class CUnwrapParams(ctypes.Structure):
         ('min_island_faces', ctypes.c_int),
         ('pack_islands', ctypes.c_int),
         ('island_margin', ctypes.c_float),
+        ('weld_epsilon', ctypes.c_float),
+        ('seam_mode', ctypes.c_int),
+        ('num_threads', ctypes.c_int),
+        ('lscm_context', ctypes.c_void_p),
     ]
 
 
@@ -89,6 +93,12 @@ class CUnwrapResult(ctypes.Structure):
 # _lib.free_mesh.argtypes = [ctypes.POINTER(CMesh)]
 # _lib.free_mesh.restype = None
 #
+# _lib.lscm_context_create.argtypes = [ctypes.c_int]
+# _lib.lscm_context_create.restype = ctypes.c_void_p
+#
+# _lib.lscm_context_free.argtypes = [ctypes.c_void_p]
+# _lib.lscm_context_free.restype = None
+#
 # ... etc for all functions
 
 
@@ -171,6 +181,13 @@ def unwrap(mesh, params=None):
             - min_island_faces: int (default 10)
             - pack_islands: bool (default True)
             - island_margin: float (default 0.02)
+            - weld_epsilon: float (default 0.0, no welding)
+            - seam_mode: int (default 0 spanning tree, 1 curvature MST,
+              2 shortest path)
+            - num_threads: int (default 0, automatic)
+            - lscm_context: handle from lscm_context_create() (default None);
+              pass the same one to repeated unwraps of a mesh so identical
+              islands skip the symbolic analysis
 
     Returns:
         tuple: (unwrapped_mesh, result_dict)
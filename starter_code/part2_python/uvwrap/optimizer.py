@@ -34,12 +34,17 @@ def optimize_parameters(mesh_path, target_metric='stretch', verbose=True):
     #      angle_thresholds = [20, 30, 40, 50]
     #      min_island_sizes = [5, 10, 20, 50]
     #
-    # 2. For each parameter combination:
-    #      Unwrap mesh with these params
+    # 2. Create one LSCM context (lscm_context_create) for the whole search;
+    #    most combinations cut the mesh into islands an earlier one already
+    #    produced, and the context lets those skip the symbolic analysis
+    #
+    # 3. For each parameter combination:
+    #      Unwrap mesh with these params (plus lscm_context)
     #      Compute target metric
     #      Track best result
     #
-    # 3. Return best parameters and score
+    # 4. Free the context (lscm_context_free) and return best parameters
+    #    and score
 
     # Parameter search space
     angle_thresholds = [20, 30, 40, 50]  # degrees